@@ -47,17 +47,23 @@ extern "C" {
 
 struct openr2_chan_s;
 struct openr2_context_s;
+struct openr2_worker_s;
+struct openr2_timer_shard_s;
 
 /* function type to be called when a scheduled event 
    for the channel is triggered */
 typedef void (*openr2_callback_t)(struct openr2_chan_s *r2chan);
 
 /* scheduled event */
-typedef struct {
+typedef struct openr2_sched_timer_s {
 	struct timeval time;
 	openr2_callback_t callback;
 	const char *name;
 	int id;
+	/* channel that owns the timer */
+	struct openr2_chan_s *r2chan;
+	/* position in the context timers heap */
+	int heap_index;
 } openr2_sched_timer_t;
 
 typedef struct openr2_chan_timer_ids_s {
@@ -100,6 +106,12 @@ typedef enum r2chan_flags_e {
 	OR2_CHAN_CALL_DNIS_CALLBACK = (1 << 0),
 } r2chan_flags_t;
 
+/* node of the channel command queue */
+typedef struct openr2_chan_command_node_s {
+	struct openr2_chan_command_node_s *next;
+	openr2_chan_command_t command;
+} openr2_chan_command_node_t;
+
 /* R2 channel. Hold the states of the R2 signaling, I/O device etc.
    The R2 variant will be inherited from the R2 context 
    this channel belongs to */
@@ -126,7 +138,8 @@ typedef struct openr2_chan_s {
 	/* forward, backward or stopped.  */
 	openr2_direction_t direction;
 
-	/* array of scheduled events in execution order */
+	/* scheduled events slots, a slot with id 0 is free. The
+	   execution order is kept by the context timers heap */
 	#define OR2_MAX_SCHED_TIMERS 10
 	openr2_sched_timer_t sched_timers[OR2_MAX_SCHED_TIMERS];
 
@@ -235,8 +248,25 @@ typedef struct openr2_chan_s {
 	/* MF threshold tone */
 	int mf_threshold_tone;
 
-	/* MF read start time */
-	struct timeval mf_threshold_time;
+	/* samples read for MF detection, as of the tone being handled. This is the
+	   MF threshold clock, so it does not depend on when the samples get processed */
+	uint32_t mf_rx_samples;
+
+	/* MF threshold tone start, in mf_rx_samples */
+	uint32_t mf_threshold_sample;
+
+	/* context clock as of the last mf_rx_samples update. Tones detected by the
+	   hardware come with no samples, then this is what moves mf_rx_samples on */
+	struct timeval mf_rx_time;
+
+	/* context clock snapshot taken at the start of the current processing pass */
+	struct timeval pass_time;
+
+	/* wall clock snapshot for logging in the current pass, zero until needed */
+	struct timeval pass_wallclock;
+
+	/* processing pass nesting level, the snapshots are valid only if non zero */
+	int pass_depth;
 
 #ifdef OR2_MF_DEBUG
 	/* MF audio debug logging */
@@ -272,6 +302,19 @@ typedef struct openr2_chan_s {
 	/* span's id this channel belong to */
 	int span_id;
 
+	/* I/O events the context reactor is watching for this channel, 0 if not watched */
+	int reactor_events;
+
+	/* context worker serving this channel, NULL if served by the context reactor */
+	struct openr2_worker_s *worker;
+
+	/* timer shard holding the scheduled timers of this channel */
+	struct openr2_timer_shard_s *timer_shard;
+
+	/* commands posted by other threads, pushed lock-free in LIFO order and
+	   drained by the thread processing the channel */
+	openr2_chan_command_node_t *volatile command_queue;
+
 } openr2_chan_t;
 
 #define openr2_chan_lock(r2chan) openr2_mutex_lock(r2chan->lock)
@@ -280,6 +323,11 @@ typedef struct openr2_chan_s {
 int openr2_chan_add_timer(openr2_chan_t *r2chan, int ms, openr2_callback_t callback, const char *name);
 void openr2_chan_cancel_timer(openr2_chan_t *r2chan, int *timer_id);
 void openr2_chan_cancel_all_timers(openr2_chan_t *r2chan);
+int openr2_chan_get_time(openr2_chan_t *r2chan, struct timeval *now);
+int openr2_chan_run_timers(openr2_chan_t *r2chan, const struct timeval *now);
+int openr2_chan_process_ready(openr2_chan_t *r2chan, int events, const struct timeval *now);
+int openr2_chan_get_wanted_events(openr2_chan_t *r2chan);
+int openr2_chan_get_wallclock(openr2_chan_t *r2chan, struct timeval *now);
 
 #if defined(__cplusplus)
 } /* endif extern "C" */
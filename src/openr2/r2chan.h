@@ -39,6 +39,34 @@ extern "C" {
 /*! \brief How many bytes to read each time at once from the channel */
 #define OR2_CHAN_READ_SIZE 160
 
+/*! \brief Actions that can be posted to a channel from any thread with openr2_chan_post_command */
+typedef enum {
+	OR2_CMD_MAKE_CALL,
+	OR2_CMD_ACCEPT_CALL,
+	OR2_CMD_ANSWER_CALL,
+	OR2_CMD_ANSWER_CALL_WITH_MODE,
+	OR2_CMD_DISCONNECT_CALL,
+	OR2_CMD_ACK_CALL,
+	OR2_CMD_SET_IDLE,
+	OR2_CMD_SET_BLOCKED
+} openr2_chan_command_type_t;
+
+/*! \brief Channel command, only the arguments of the command type are used */
+typedef struct {
+	openr2_chan_command_type_t type;
+	union {
+		struct {
+			char ani[OR2_MAX_ANI];
+			char dnis[OR2_MAX_DNIS];
+			openr2_calling_party_category_t category;
+			int ani_restricted;
+		} make_call;
+		openr2_call_mode_t accept_mode;
+		openr2_answer_mode_t answer_mode;
+		openr2_call_disconnect_cause_t disconnect_cause;
+	} args;
+} openr2_chan_command_t;
+
 /* callback for logging channel related info */
 typedef void (*openr2_chan_logging_func_t)(openr2_chan_t *r2chan, const char *file, const char *function, unsigned int line, openr2_log_level_t level, const char *fmt, va_list ap);
 
@@ -149,6 +177,11 @@ OR2_DECLARE(int) openr2_chan_process_signaling(openr2_chan_t *r2chan);
 /*! \brief check if there is any expired timer and execute the timeout callbacks if needed */
 OR2_DECLARE(int) openr2_chan_run_schedule(openr2_chan_t *r2chan);
 
+/*! \brief run the expired timers and handle the OR2_IO_* events in io_events_in the channel is known to be ready for,
+ * without polling the device nor blocking. On return io_events_wanted has the events the channel wants to be
+ * stepped for next and next_deadline_ms the milliseconds until its next timer (-1 if none), either can be NULL */
+OR2_DECLARE(int) openr2_chan_step(openr2_chan_t *r2chan, int io_events_in, int *io_events_wanted, int *next_deadline_ms);
+
 /*! \brief return the last CAS bits received */
 OR2_DECLARE(openr2_cas_signal_t) openr2_chan_get_rx_cas(openr2_chan_t *r2chan);
 
@@ -194,6 +227,10 @@ OR2_DECLARE(void) openr2_chan_set_span_id(openr2_chan_t *r2chan, int span_id);
 /*! \brief acknowledge incoming call */
 OR2_DECLARE(int) openr2_chan_ack_call(openr2_chan_t *r2chan);
 
+/*! \brief queue a command to be executed by the thread processing the channel at the start of its next processing pass,
+ * never blocks on the channel lock and can be called from any thread */
+OR2_DECLARE(int) openr2_chan_post_command(openr2_chan_t *r2chan, const openr2_chan_command_t *command);
+
 #ifdef __OR2_COMPILING_LIBRARY__
 #undef openr2_chan_t
 #undef openr2_context_t
@@ -38,6 +38,8 @@ extern "C" {
 /* we dont include openr2_chan_t because r2chan.h 
    already include us */
 struct openr2_chan_s;
+struct openr2_sched_timer_s;
+struct openr2_worker_s;
 
 /* R2 protocol timers */
 typedef struct {
@@ -69,6 +71,84 @@ typedef struct {
 	int r2_seize_persist;
 } openr2_timers_t;
 
+/* number of timer shards of the context reactor, channels are spread by number */
+#define OR2_TIMER_SHARDS 16
+
+/* scheduled timers of a group of channels. The heap is accessed with the shard lock
+   held, the earliest deadline summary can be read without it through a seqlock */
+typedef struct openr2_timer_shard_s {
+	/* access token to the heap */
+	openr2_mutex_t *lock;
+
+	/* binary min-heap with the scheduled timers, the root is the next timer to expire */
+	struct openr2_sched_timer_s **heap;
+
+	/* number of timers in the heap */
+	int len;
+
+	/* number of timers the heap has room for */
+	int size;
+
+	/* summary sequence number, odd while the summary is being updated */
+	volatile unsigned int seq;
+
+	/* whether there is any timer scheduled and the expiration time of the heap root */
+	int pending;
+	struct timeval earliest;
+
+	/* context this shard belongs to */
+	struct openr2_context_s *r2context;
+
+	/* worker to wake up when the earliest deadline changes, NULL
+	   if the context timer fd must be re-armed instead */
+	struct openr2_worker_s *worker;
+} openr2_timer_shard_t;
+
+/* Channels are served either by the context reactor or by a context worker. Each of them
+   holds its serving lock while processing channels, and a channel only joins or leaves one
+   of them with its serving lock held, so a channel found ready or with expired timers stays
+   alive until the serving lock is released. The context reactor lock is always taken before
+   any worker lock, and serving locks are taken before the channel lock */
+
+/* context worker thread, serves the channels of the spans assigned to it */
+typedef struct openr2_worker_s {
+	/* context this worker belongs to */
+	struct openr2_context_s *r2context;
+
+	/* worker number, channels are assigned by span_id modulo the number of workers */
+	int id;
+
+	/* CPU the worker thread is pinned to, -1 if not pinned */
+	int cpu;
+
+	/* epoll set watching the channels assigned to this worker */
+	int reactor_fd;
+
+	/* pipe used to wake up the worker from other threads */
+	int reactor_wakefd[2];
+
+	/* set to ask the worker thread to exit */
+	volatile int stop;
+
+	/* worker thread, NULL if not started */
+	openr2_thread_t *thread;
+
+	/* serving lock, held while the worker processes its channels */
+	openr2_mutex_t *lock;
+
+	/* list of channels served by this worker */
+	struct openr2_chan_s *chanlist;
+
+	/* bumped every time a channel leaves this worker */
+	volatile unsigned int removals;
+
+	/* id of the worker thread, 0 until it starts */
+	volatile unsigned long thread_id;
+
+	/* timers of the channels served by this worker */
+	openr2_timer_shard_t timers;
+} openr2_worker_t;
+
 typedef enum r2context_flags_e {
 	OR2_ANI_CAN_COME_FIRST = (1 << 0),
 	OR2_FORCE_USE_MAX_ANI = (1 << 1),
@@ -89,6 +169,10 @@ typedef struct openr2_context_s {
 	   to the R2 channels */
 	openr2_mflib_interface_t *mflib;
 
+	/* mf_generate_tone() of the MF interface producing A-law
+	   samples ready to be written, NULL if not available */
+	openr2_mf_generate_alaw_func mf_generate_alaw;
+
 	/* this interface provides event management 
 	   functions */
 	openr2_event_interface_t *evmanager;
@@ -97,6 +181,11 @@ typedef struct openr2_context_s {
 	   functions to the R2 channels */
 	openr2_transcoder_interface_t *transcoder;
 
+	/* whole buffer versions of the transcoder routines, 
+	   NULL to transcode sample by sample */
+	openr2_alaw_to_linear_n_func alaw_to_linear_n;
+	openr2_linear_to_alaw_n_func linear_to_alaw_n;
+
 	/* this interface provide I/O
 	   functions to the R2 channels */
 	openr2_io_interface_t *io;
@@ -108,6 +197,10 @@ typedef struct openr2_context_s {
 	   to the R2 channels */
 	openr2_dtmf_interface_t *dtmfeng;
 
+	/* dtmf_tx() of the DTMF interface producing A-law
+	   samples ready to be written, NULL if not available */
+	openr2_dtmf_tx_alaw_func dtmf_tx_alaw;
+
 	/* R2 variant to use in this context channels */
 	openr2_variant_t variant;
 
@@ -155,6 +248,10 @@ typedef struct openr2_context_s {
 	/* MF threshold time in ms */
 	int mf_threshold;
 
+	/* MF detection block length and samples between decisions, for the built-in detector */
+	int mf_block;
+	int mf_hop;
+
 	/* use DTMF for outbound dialing */
 	int dial_with_dtmf;
 
@@ -176,12 +273,53 @@ typedef struct openr2_context_s {
 	/* whether or not the advanced configuration file was used */
 	int configured_from_file;
 
-	/* access token to the timers */
+	/* access token to the timer fd creation and the clock source, 
+	   channel timers are protected by the lock of their shard */
 	openr2_mutex_t *timers_lock;
 
-	/* list of channels that belong to this context */
+	/* timers of the channels not served by a worker */
+	openr2_timer_shard_t timer_shards[OR2_TIMER_SHARDS];
+
+	/* timerfd armed to expire with the earliest timer of 
+	   the timer shards, -1 if not created */
+	int timer_fd;
+
+	/* clock used for timers and MF threshold checks */
+	openr2_clock_source_t clock_source;
+
+	/* OS clock id for clock_gettime() matching clock_source */
+	int clock_id;
+
+	/* how far behind the clock can lag in nanoseconds, the timer fd is armed
+	   that much later so the clock reached the deadline when it fires */
+	long clock_lag_ns;
+
+	/* list of channels served by the context reactor, the
+	   ones served by a worker are in the list of the worker */
 	struct openr2_chan_s *chanlist;
 
+	/* serving lock of the context reactor */
+	openr2_mutex_t *reactor_lock;
+
+	/* bumped every time a channel leaves the context reactor */
+	volatile unsigned int reactor_removals;
+
+	/* epoll set watching the file descriptors of all 
+	   the channels in this context, -1 if not available */
+	int reactor_fd;
+
+	/* pipe used to wake up the reactor from other threads */
+	int reactor_wakefd[2];
+
+	/* set to ask openr2_context_run() to return */
+	volatile int reactor_stop;
+
+	/* worker threads serving the channels, NULL if not started */
+	openr2_worker_t *workers;
+
+	/* number of worker threads */
+	int num_workers;
+
 	/* context flags */
 	r2context_flags_t flags;
 
@@ -190,6 +328,15 @@ typedef struct openr2_context_s {
 
 void openr2_context_add_channel(openr2_context_t *r2context, struct openr2_chan_s *r2chan);
 void openr2_context_remove_channel(openr2_context_t *r2context, struct openr2_chan_s *r2chan);
+int openr2_context_get_time(openr2_context_t *r2context, struct timeval *now);
+int openr2_timer_shard_add(openr2_timer_shard_t *shard, struct openr2_sched_timer_s *timer);
+void openr2_timer_shard_remove(openr2_timer_shard_t *shard, struct openr2_sched_timer_s *timer);
+void openr2_context_wakeup(openr2_context_t *r2context, struct openr2_chan_s *r2chan);
+void openr2_context_worker_wakeup(openr2_worker_t *worker);
+void openr2_context_assign_worker(openr2_context_t *r2context, struct openr2_chan_s *r2chan);
+int openr2_context_native_mf(openr2_context_t *r2context);
+int openr2_context_native_dtmf(openr2_context_t *r2context);
+void openr2_context_configure_mf_rx(openr2_context_t *r2context, void *mf_read_handle);
 #include "r2context.h"
 
 #if defined(__cplusplus)
@@ -45,6 +45,7 @@ typedef int (*openr2_mf_select_tone_func)(void *write_handle, char signal);
 typedef int (*openr2_mf_want_generate_func)(void *write_handle, int signal);
 typedef void (*openr2_mf_read_dispose_func)(void *read_handle);
 typedef void (*openr2_mf_write_dispose_func)(void *write_handle);
+typedef int (*openr2_mf_generate_alaw_func)(void *write_handle, uint8_t buffer[], int samples);
 typedef struct {
 	/* init routines to detect and generate tones */
 	openr2_mf_read_init_func mf_read_init;
@@ -185,6 +186,8 @@ typedef enum {
    viceversa */
 typedef int16_t (*openr2_alaw_to_linear_func)(uint8_t alaw);
 typedef uint8_t (*openr2_linear_to_alaw_func)(int linear);
+typedef void (*openr2_alaw_to_linear_n_func)(const uint8_t alaw[], int16_t linear[], int samples);
+typedef void (*openr2_linear_to_alaw_n_func)(const int16_t linear[], uint8_t alaw[], int samples);
 typedef struct {
 	openr2_alaw_to_linear_func alaw_to_linear;
 	openr2_linear_to_alaw_func linear_to_alaw;
@@ -196,6 +199,7 @@ typedef void *(*openr2_dtmf_tx_init_func)(void *dtmf_write_handle);
 typedef void (*openr2_dtmf_tx_set_timing_func)(void *dtmf_write_handle, int on_time, int off_time);
 typedef int (*openr2_dtmf_tx_put_func)(void *dtmf_write_handle, const char *digits, int len);
 typedef int (*openr2_dtmf_tx_func)(void *dtmf_write_handle, int16_t amp[], int max_samples);
+typedef int (*openr2_dtmf_tx_alaw_func)(void *dtmf_write_handle, uint8_t alaw[], int max_samples);
 
 /* DTMF receiver part of the openr2_dtmf_interface_t */
 typedef void (*openr2_digits_rx_callback_t)(void *user_data, const char *digits, int len);
@@ -216,6 +220,16 @@ typedef struct {
 	openr2_dtmf_rx_func dtmf_rx;
 } openr2_dtmf_interface_t;
 
+/* Clock sources for the context timers and MF threshold checks */
+typedef enum {
+	/* Monotonic clock, not affected by wall clock changes (default) */
+	OR2_CLOCK_MONOTONIC = 0,
+	/* Cheaper monotonic clock with system tick resolution (Linux only) */
+	OR2_CLOCK_MONOTONIC_COARSE,
+	/* Wall clock (gettimeofday) */
+	OR2_CLOCK_REALTIME
+} openr2_clock_source_t;
+
 /* Library errors */
 typedef enum {
 	/* Failed system call */
@@ -231,10 +245,17 @@ typedef enum {
 	/* Out of memory */
 	OR2_LIBERR_OUT_OF_MEMORY,
 	/* Invalid interface provided */
-	OR2_LIBERR_INVALID_INTERFACE
+	OR2_LIBERR_INVALID_INTERFACE,
+	/* Operation not supported on this platform */
+	OR2_LIBERR_NOT_SUPPORTED
 } openr2_liberr_t;
 
 OR2_DECLARE(int) openr2_context_get_time_to_next_event(openr2_context_t *r2context);
+OR2_DECLARE(int) openr2_context_run_schedule(openr2_context_t *r2context);
+OR2_DECLARE(int) openr2_context_process_ready(openr2_context_t *r2context, openr2_chan_t **chans, int *events, int n);
+OR2_DECLARE(int) openr2_context_get_timer_fd(openr2_context_t *r2context);
+OR2_DECLARE(int) openr2_context_set_clock_source(openr2_context_t *r2context, openr2_clock_source_t source);
+OR2_DECLARE(openr2_clock_source_t) openr2_context_get_clock_source(openr2_context_t *r2context);
 OR2_DECLARE(openr2_context_t *) openr2_context_new(openr2_variant_t variant, openr2_event_interface_t *callmgmt, int max_ani, int max_dnis);
 OR2_DECLARE(void) openr2_context_delete(openr2_context_t *r2context);
 OR2_DECLARE(openr2_liberr_t) openr2_context_get_last_error(openr2_context_t *r2context);
@@ -252,6 +273,8 @@ OR2_DECLARE(void) openr2_context_set_log_level(openr2_context_t *r2context, open
 OR2_DECLARE(openr2_log_level_t) openr2_context_get_log_level(openr2_context_t *r2context);
 OR2_DECLARE(void) openr2_context_set_mf_threshold(openr2_context_t *r2context, int threshold);
 OR2_DECLARE(int) openr2_context_get_mf_threshold(openr2_context_t *r2context);
+OR2_DECLARE(int) openr2_context_set_mf_block(openr2_context_t *r2context, int block, int hop);
+OR2_DECLARE(int) openr2_context_get_mf_block(openr2_context_t *r2context, int *hop);
 OR2_DECLARE(int) openr2_context_set_log_directory(openr2_context_t *r2context, char *directory);
 OR2_DECLARE(char *) openr2_context_get_log_directory(openr2_context_t *r2context, char *directory, int len);
 OR2_DECLARE(void) openr2_context_set_mf_back_timeout(openr2_context_t *r2context, int ms);
@@ -268,10 +291,18 @@ OR2_DECLARE(void) openr2_context_set_dtmf_dialing(openr2_context_t *r2context, i
 OR2_DECLARE(int) openr2_context_get_dtmf_dialing(openr2_context_t *r2context, int *dtmf_on, int *dtmf_off);
 OR2_DECLARE(int) openr2_context_set_dtmf_interface(openr2_context_t *r2context, openr2_dtmf_interface_t *dtmf_interface);
 OR2_DECLARE(int) openr2_context_set_mflib_interface(openr2_context_t *r2context, openr2_mflib_interface_t *mflib);
+OR2_DECLARE(int) openr2_context_set_mf_alaw_generator(openr2_context_t *r2context, openr2_mf_generate_alaw_func mf_generate_alaw);
+OR2_DECLARE(int) openr2_context_set_dtmf_alaw_generator(openr2_context_t *r2context, openr2_dtmf_tx_alaw_func dtmf_tx_alaw);
 OR2_DECLARE(int) openr2_context_set_transcoder_interface(openr2_context_t *r2context, openr2_transcoder_interface_t *transcoder);
+OR2_DECLARE(int) openr2_context_set_bulk_transcoder(openr2_context_t *r2context, openr2_alaw_to_linear_n_func alaw_to_linear_n, openr2_linear_to_alaw_n_func linear_to_alaw_n);
 OR2_DECLARE(void) openr2_context_set_max_dnis(openr2_context_t *r2context, int max_dnis);
 OR2_DECLARE(void) openr2_context_set_max_ani(openr2_context_t *r2context, int max_ani);
 OR2_DECLARE(void) openr2_context_set_auto_seize_ack(openr2_context_t *r2context, int enable);
+OR2_DECLARE(int) openr2_context_poll_once(openr2_context_t *r2context, int timeout);
+OR2_DECLARE(int) openr2_context_run(openr2_context_t *r2context);
+OR2_DECLARE(void) openr2_context_stop(openr2_context_t *r2context);
+OR2_DECLARE(int) openr2_context_start_workers(openr2_context_t *r2context, int num_workers, const int *cpus);
+OR2_DECLARE(int) openr2_context_stop_workers(openr2_context_t *r2context);
 
 #ifdef __OR2_COMPILING_LIBRARY__
 #undef openr2_chan_t 
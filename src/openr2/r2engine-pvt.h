@@ -42,13 +42,18 @@ extern "C" {
 #endif
 
 #define OR2_MAX_DTMF_DIGITS 128
+/* Detection block lengths, in samples */
+#define OR2_MF_RX_BLOCK_SAMPLES 133
+#define OR2_MF_RX_MIN_BLOCK_SAMPLES 80
+#define OR2_DTMF_RX_BLOCK_SAMPLES 102
 
 typedef void (*tone_report_func_t)(void *user_data, int code, int level, int delay);
 
 typedef struct
 {
     int32_t phase_rate;
-    float gain;
+    /*! The amplitude, or the Q15 modulation depth for amplitude modulated tones. */
+    int32_t gain;
 } openr2_tone_gen_tone_descriptor_t;
 
 /*!
@@ -78,22 +83,32 @@ typedef struct
 } openr2_tone_gen_state_t;
 
 /*!
-    Floating point Goertzel filter descriptor.
+    Goertzel filter values. When built with OR2_USE_FIXED_POINT the filters run
+    on 32 bit integers with Q14 coefficients, otherwise on single precision floats.
+*/
+#if defined(OR2_USE_FIXED_POINT)
+typedef int32_t openr2_goertzel_value_t;
+#else
+typedef float openr2_goertzel_value_t;
+#endif
+
+/*!
+    Goertzel filter descriptor.
 */
 typedef struct
 {
-    float fac;
+    openr2_goertzel_value_t fac;
     int samples;
 } openr2_goertzel_descriptor_t;
 
 /*!
-    Floating point Goertzel filter state descriptor.
+    Goertzel filter state descriptor.
 */
 typedef struct
 {
-    float v2;
-    float v3;
-    float fac;
+    openr2_goertzel_value_t v2;
+    openr2_goertzel_value_t v3;
+    openr2_goertzel_value_t fac;
     int samples;
     int current_sample;
 } openr2_goertzel_state_t;
@@ -109,6 +124,10 @@ struct openr2_mf_tx_state
     int fwd;
     /*! The current digit being generated. */
     int digit;
+    /*! The cached A-law waveform of the current digit, if any. */
+    const uint8_t *cached;
+    /*! The position within the cached waveform. */
+    int cached_pos;
 };
 
 /*!
@@ -124,6 +143,71 @@ struct openr2_mf_rx_state
     int current_sample;
     /*! The currently detected digit. */
     int current_digit;
+    /*! The detection block length, in samples. */
+    int block;
+    /*! The samples between detection decisions. Equal to the block length for
+        back to back blocks, shorter for overlapping (sliding) blocks. */
+    int hop;
+    /*! The detection threshold, scaled for the block length. */
+    float threshold;
+    /*! The magnitude sum below which a block cannot hold a tone. */
+    int silence_limit;
+    /*! Back to back blocks: the sum of the sample magnitudes of the current block
+        while it may still be silence, -1 once it is not and the filters are being
+        run. Sliding blocks: the sum of the sample magnitudes of the last block. */
+    int silence_sum;
+    /*! Back to back blocks: the samples of the current block held back from the
+        filters while it may still be silence. Sliding blocks: the last block of
+        samples, as a ring starting at replay_pos. */
+    int16_t replay[OR2_MF_RX_BLOCK_SAMPLES];
+    /*! The oldest sample in the replay ring, for sliding blocks. */
+    int replay_pos;
+};
+
+/*!
+    MFC/R2 tone detector for both directions at once. All twelve filters are run
+    over the samples together, forward ones first.
+*/
+struct openr2_mf_rx_dual_state
+{
+    /*! Tone detector working states, the six forward filters then the six backward ones */
+    openr2_goertzel_state_t out[12];
+    /*! The current sample number within a processing block. */
+    int current_sample;
+    /*! The sum of the sample magnitudes of the current block while it may still be
+        silence, -1 once it is not and the filters are being run. */
+    int silence_sum;
+    /*! The samples of the current block held back from the filters while it may
+        still be silence. */
+    int16_t replay[OR2_MF_RX_BLOCK_SAMPLES];
+};
+
+/*!
+    Bank of MFC/R2 tone detectors. The filter states are kept filter by filter,
+    with one entry per channel, so the same filter of neighbouring channels is
+    run in the vector lanes. All the channels share the block timing.
+*/
+struct openr2_mf_rx_bank
+{
+    /*! The number of channels in the bank. */
+    int channels;
+    /*! The channels rounded up to a whole number of vector lanes. */
+    int stride;
+    /*! Filter coefficients, 6 filters of stride entries each. */
+    openr2_goertzel_value_t *fac;
+    /*! Filter states, laid out as the coefficients. */
+    openr2_goertzel_value_t *v2;
+    openr2_goertzel_value_t *v3;
+    /*! The samples of the current block for every channel, sample by sample. */
+    openr2_goertzel_value_t *amp;
+    /*! TRUE for the channels detecting forward tones. */
+    int *fwd;
+    /*! TRUE for the channels initialised in the middle of the current block. */
+    int *partial;
+    /*! The currently detected digit of every channel. */
+    int *current_digit;
+    /*! The current sample number within a processing block. */
+    int current_sample;
 };
 
 /*!
@@ -133,8 +217,8 @@ struct openr2_mf_rx_state
 struct openr2_dtmf_tx_state
 {
     openr2_tone_gen_state_t tones;
-    float low_level;
-    float high_level;
+    int32_t low_level;
+    int32_t high_level;
     int on_time;
     int off_time;
     union
@@ -165,22 +249,32 @@ struct openr2_dtmf_rx_state
     float reverse_twist;
 
     /*! 350Hz filter state for the optional dialtone filter */
-    float z350[2];
+    openr2_goertzel_value_t z350[2];
     /*! 440Hz filter state for the optional dialtone filter */
-    float z440[2];
+    openr2_goertzel_value_t z440[2];
 
     /*! Tone detector working states for the row tones. */
     openr2_goertzel_state_t row_out[4];
     /*! Tone detector working states for the column tones. */
     openr2_goertzel_state_t col_out[4];
     /*! The accumlating total energy on the same period over which the Goertzels work. */
+#if defined(OR2_USE_FIXED_POINT)
+    int64_t energy;
+#else
     float energy;
+#endif
     /*! The result of the last tone analysis. */
     uint8_t last_hit;
     /*! The confirmed digit we are currently receiving */
     uint8_t in_digit;
     /*! The current sample number within a processing block. */
     int current_sample;
+    /*! The sum of the sample magnitudes of the current block while it may still be
+        silence, -1 once it is not and the filters are being run. */
+    openr2_goertzel_value_t silence_sum;
+    /*! The samples of the current block held back from the filters while it may
+        still be silence. */
+    openr2_goertzel_value_t replay[OR2_DTMF_RX_BLOCK_SAMPLES];
 
     /*! The number of digits which have been lost due to buffer overflows. */
     int lost_digits;
@@ -239,6 +333,10 @@ static __inline__ int openr2_top_bit(unsigned int bits)
 #endif
 }
 
+extern const int16_t openr2_alaw_to_linear_table[256];
+
+int openr2_mf_tx_cache_init(void);
+
 static __inline__ int16_t openr2_alaw_to_linear(uint8_t alaw)
 {
     int i;
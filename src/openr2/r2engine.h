@@ -46,26 +46,88 @@ typedef struct openr2_mf_rx_state openr2_mf_rx_state_t;
 typedef struct openr2_mf_tx_state openr2_mf_tx_state_t;
 typedef struct openr2_dtmf_tx_state openr2_dtmf_tx_state_t;
 typedef struct openr2_dtmf_rx_state openr2_dtmf_rx_state_t;
+typedef struct openr2_mf_rx_bank openr2_mf_rx_bank_t;
+typedef struct openr2_mf_rx_dual_state openr2_mf_rx_dual_state_t;
+
+/* A change of the MF tone being received, digit is 0 when the tone stops. sample is
+   the index, within the samples passed, of the last sample of the detection block
+   the change was decided on */
+typedef struct {
+	int digit;
+	int sample;
+} openr2_mf_rx_event_t;
+
+/* DSP kernel variants, from the least to the most capable. The best one this CPU
+   can run is picked when the library is loaded, unless the OPENR2_DSP environment
+   variable names another one (scalar, sse2, avx2 or neon) */
+typedef enum {
+	OR2_DSP_SCALAR = 0,
+	OR2_DSP_SSE2,
+	OR2_DSP_AVX2,
+	OR2_DSP_NEON,
+	OR2_DSP_VARIANTS
+} openr2_dsp_variant_t;
+
+/* Force a variant for benchmarking, -1 if it was not built or this CPU cannot run it.
+   Switch before starting any channel, the kernels are shared by everyone */
+OR2_DECLARE(int) openr2_dsp_set_variant(openr2_dsp_variant_t variant);
+OR2_DECLARE(openr2_dsp_variant_t) openr2_dsp_get_variant(void);
+OR2_DECLARE(const char *) openr2_dsp_get_variant_name(openr2_dsp_variant_t variant);
+
+/* Bulk A-law transcoding routines */
+OR2_DECLARE(void) openr2_alaw_to_linear_n(const uint8_t alaw[], int16_t linear[], int samples);
+OR2_DECLARE(void) openr2_linear_to_alaw_n(const int16_t linear[], uint8_t alaw[], int samples);
 
 /* MF Rx routines */
 OR2_DECLARE(openr2_mf_rx_state_t *) openr2_mf_rx_init(openr2_mf_rx_state_t *s, int fwd);
 OR2_DECLARE(int) openr2_mf_rx(openr2_mf_rx_state_t *s, const int16_t amp[], int samples);
+OR2_DECLARE(int) openr2_mf_rx_alaw(openr2_mf_rx_state_t *s, const uint8_t alaw[], int samples);
+/* Detect over blocks of block samples (80 to 133, the default), deciding every
+   hop samples (1 to block, 0 for back to back blocks) */
+OR2_DECLARE(int) openr2_mf_rx_set_block(openr2_mf_rx_state_t *s, int block, int hop);
+/* Detect and report every change of tone, in order, returning how many there were.
+   Changes past max_events are not reported, openr2_mf_rx_get_digit() still has the
+   latest state. There is at most one change every hop samples */
+OR2_DECLARE(int) openr2_mf_rx_events(openr2_mf_rx_state_t *s, const int16_t amp[], int samples, openr2_mf_rx_event_t events[], int max_events);
+OR2_DECLARE(int) openr2_mf_rx_alaw_events(openr2_mf_rx_state_t *s, const uint8_t alaw[], int samples, openr2_mf_rx_event_t events[], int max_events);
+OR2_DECLARE(int) openr2_mf_rx_get_digit(openr2_mf_rx_state_t *s);
+
+/* MF Rx routines for both directions of the same samples at once, for monitoring a
+   timeslot. Always works on back to back blocks of the default length, and leaves in
+   fwd_digit and back_digit what openr2_mf_rx would have returned for forward and
+   backward states */
+OR2_DECLARE(openr2_mf_rx_dual_state_t *) openr2_mf_rx_dual_init(openr2_mf_rx_dual_state_t *s);
+OR2_DECLARE(void) openr2_mf_rx_dual(openr2_mf_rx_dual_state_t *s, const int16_t amp[], int samples, int *fwd_digit, int *back_digit);
+OR2_DECLARE(void) openr2_mf_rx_dual_alaw(openr2_mf_rx_dual_state_t *s, const uint8_t alaw[], int samples, int *fwd_digit, int *back_digit);
+
+/* MF Rx routines for many channels at once. Every call runs the same number of samples
+   for all the channels, amp[n] being the samples of channel n or NULL for silence, and
+   leaves in digits[n] what openr2_mf_rx would have returned for that channel */
+OR2_DECLARE(openr2_mf_rx_bank_t *) openr2_mf_rx_bank_new(int channels);
+OR2_DECLARE(void) openr2_mf_rx_bank_delete(openr2_mf_rx_bank_t *bank);
+OR2_DECLARE(int) openr2_mf_rx_bank_init(openr2_mf_rx_bank_t *bank, int channel, int fwd);
+OR2_DECLARE(int) openr2_mf_rx_bank(openr2_mf_rx_bank_t *bank, const int16_t *amp[], int samples, int digits[]);
 
 /* MF Tx routines */
 OR2_DECLARE(openr2_mf_tx_state_t *) openr2_mf_tx_init(openr2_mf_tx_state_t *s, int fwd);
 OR2_DECLARE(int) openr2_mf_tx(openr2_mf_tx_state_t *s, int16_t amp[], int samples);
 OR2_DECLARE(int) openr2_mf_tx_put(openr2_mf_tx_state_t *s, char digit);
+OR2_DECLARE(int) openr2_mf_tx_alaw(openr2_mf_tx_state_t *s, uint8_t alaw[], int samples);
 
 /* DTMF Tx routines */
 OR2_DECLARE(int) openr2_dtmf_tx(openr2_dtmf_tx_state_t *s, int16_t amp[], int max_samples);
+OR2_DECLARE(int) openr2_dtmf_tx_alaw(openr2_dtmf_tx_state_t *s, uint8_t alaw[], int max_samples);
 OR2_DECLARE(size_t) openr2_dtmf_tx_put(openr2_dtmf_tx_state_t *s, const char *digits, int len);
 OR2_DECLARE(void) openr2_dtmf_tx_set_timing(openr2_dtmf_tx_state_t *s, int on_time, int off_time);
-OR2_DECLARE(void) openr2_dtmf_tx_set_level(openr2_dtmf_tx_state_t *s, int level, int twist);
+/* The level and level + twist are in dBm0 and must be within -63 to +3, otherwise
+   -1 is returned and the levels are left as they were */
+OR2_DECLARE(int) openr2_dtmf_tx_set_level(openr2_dtmf_tx_state_t *s, int level, int twist);
 OR2_DECLARE(openr2_dtmf_tx_state_t *) openr2_dtmf_tx_init(openr2_dtmf_tx_state_t *s);
 
 /* DTMF Rx routines */
 OR2_DECLARE(openr2_dtmf_rx_state_t *) openr2_dtmf_rx_init(openr2_dtmf_rx_state_t *s, openr2_digits_rx_callback_t callback, void *user_data);
 OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[], int samples);
+OR2_DECLARE(int) openr2_dtmf_rx_alaw(openr2_dtmf_rx_state_t *s, const uint8_t alaw[], int samples);
 OR2_DECLARE(int) openr2_dtmf_rx_status(openr2_dtmf_rx_state_t *s);
 
 #if defined(__cplusplus)
@@ -99,6 +99,7 @@ typedef enum { OR2_SUCCESS, OR2_FAIL, OR2_TIMEOUT } openr2_status_t;
 typedef struct openr2_mutex openr2_mutex_t;
 typedef struct openr2_thread openr2_thread_t;
 typedef struct openr2_interrupt openr2_interrupt_t;
+typedef struct openr2_interrupt_set openr2_interrupt_set_t;
 typedef void *(*openr2_thread_function_t) (openr2_thread_t *, void *);
 
 struct openr2_interrupt {
@@ -107,7 +108,7 @@ struct openr2_interrupt {
     /* for generic interruption */
     HANDLE event;
 #else
-    /* for generic interruption */
+    /* for generic interruption, both are the same eventfd where available */
     int readfd;
     int writefd;
 #endif
@@ -130,6 +131,10 @@ struct openr2_thread {
 openr2_status_t openr2_thread_create_detached(openr2_thread_function_t func, void *data);
 openr2_status_t openr2_thread_create_detached_ex(openr2_thread_function_t func, void *data, size_t stack_size);
 
+/* threads created joinable must be waited for and released with openr2_thread_join() */
+openr2_status_t openr2_thread_create_joinable(openr2_thread_t **thread, openr2_thread_function_t func, void *data);
+openr2_status_t openr2_thread_join(openr2_thread_t *thread);
+
 openr2_status_t openr2_mutex_create(openr2_mutex_t **mutex);
 openr2_status_t openr2_mutex_destroy(openr2_mutex_t **mutex);
 
@@ -148,9 +153,20 @@ openr2_status_t openr2_interrupt_signal(openr2_interrupt_t *cond);
 openr2_status_t openr2_interrupt_wait(openr2_interrupt_t *cond, int ms);
 openr2_status_t openr2_interrupt_multiple_wait(openr2_interrupt_t *interrupts[], size_t size, int ms);
 
+/* a set of interrupts built once to be waited on repeatedly, the cost of
+   each wait does not depend on the number of interrupts where epoll is available */
+openr2_status_t openr2_interrupt_set_create(openr2_interrupt_set_t **set);
+openr2_status_t openr2_interrupt_set_destroy(openr2_interrupt_set_t **set);
+openr2_status_t openr2_interrupt_set_add(openr2_interrupt_set_t *set, openr2_interrupt_t *interrupt);
+openr2_status_t openr2_interrupt_set_remove(openr2_interrupt_set_t *set, openr2_interrupt_t *interrupt);
+openr2_status_t openr2_interrupt_set_wait(openr2_interrupt_set_t *set, int ms);
+
 /* when pthread is available, return thread_id. -1 otherwise */
 unsigned long openr2_thread_self(void);
 
+/* pin the calling thread to the given CPU */
+openr2_status_t openr2_thread_set_cpu_affinity(int cpu);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,21 @@ extern "C" {
 #define openr2_clear_flag(r2chan, flag) (r2chan)->flags &= ~flag
 #define openr2_test_flag(r2chan, flag) ((r2chan)->flags & flag)
 
+/* atomic pointer compare and swap, true if *ptr was oldval and has been replaced with newval */
+#ifdef WIN32
+#define openr2_atomic_cas_ptr(ptr, oldval, newval) \
+	(InterlockedCompareExchangePointer((PVOID volatile *)(ptr), (newval), (oldval)) == (oldval))
+#else
+#define openr2_atomic_cas_ptr(ptr, oldval, newval) __sync_bool_compare_and_swap((ptr), (oldval), (newval))
+#endif
+
+/* full memory barrier */
+#ifdef WIN32
+#define openr2_atomic_barrier() MemoryBarrier()
+#else
+#define openr2_atomic_barrier() __sync_synchronize()
+#endif
+
 #define OR2_EXPORT_SYMBOL __attribute__((visibility("default")))
 
 #define openr2_timercmp(a, b, CMP)                                           \
@@ -57,6 +72,18 @@ extern "C" {
 
 #define openr2_timerclear(tvp) ((tvp)->tv_sec = (tvp)->tv_usec = 0)
 
+/* milliseconds from b to a */
+#define openr2_timerdiff_ms(a, b) ((((a)->tv_sec - (b)->tv_sec) * 1000) + (((a)->tv_usec - (b)->tv_usec) / 1000))
+
+/* whether a timer with the given deadline is due at now, every expiry check must agree on this */
+#define openr2_timer_due(deadline, now) (openr2_timerdiff_ms(deadline, now) <= 0)
+
+/* milliseconds to wait for a timer with the given deadline, rounded up so 
+   that waiting them finds the timer due instead of waiting 0 ms again */
+#define openr2_timer_wait_ms(deadline, now) \
+	(openr2_timer_due(deadline, now) ? 0 : \
+	 (int)(((((long long)(deadline)->tv_sec - (now)->tv_sec) * 1000000) + ((deadline)->tv_usec - (now)->tv_usec) + 999) / 1000))
+
 /* quick access to context Multi Frequency Interface */
 #define MFI(r2chan) (r2chan)->r2context->mflib
 
@@ -174,6 +174,8 @@ OR2_DECLARE(void) openr2_chan_set_span_id(openr2_chan_t *r2chan, int span_id)
 	openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_DEBUG, "Setting span_id: %d\n", span_id);
 	r2chan->span_id = span_id;
 	openr2_chan_unlock(r2chan);
+	/* the span decides which context worker serves the channel */
+	openr2_context_assign_worker(r2chan->r2context, r2chan);
 }
 
 OR2_DECLARE(int) openr2_chan_set_dtmf_handles(openr2_chan_t *r2chan, void *dtmf_read_handle, void *dtmf_write_handle)
@@ -266,26 +268,84 @@ static int openr2_chan_handle_oob_event(openr2_chan_t *r2chan, openr2_oob_event_
 	return 0;
 }
 
+/* current time of the context clock, if there is a processing pass going on its snapshot is used */
+int openr2_chan_get_time(openr2_chan_t *r2chan, struct timeval *now)
+{
+	if (r2chan->pass_depth) {
+		*now = r2chan->pass_time;
+		return 0;
+	}
+	return openr2_context_get_time(r2chan->r2context, now);
+}
+
+/* wall clock time for logging, read at most once per processing pass */
+int openr2_chan_get_wallclock(openr2_chan_t *r2chan, struct timeval *now)
+{
+	if (!r2chan->pass_depth) {
+		return gettimeofday(now, NULL);
+	}
+	if (!r2chan->pass_wallclock.tv_sec && gettimeofday(&r2chan->pass_wallclock, NULL)) {
+		return -1;
+	}
+	*now = r2chan->pass_wallclock;
+	return 0;
+}
+
+/*! \brief must be called with chan lock held, takes the clock snapshot used during the pass
+ * unless the caller already has one */
+static int openr2_chan_begin_pass(openr2_chan_t *r2chan, const struct timeval *now)
+{
+	/* nested passes share the snapshot of the outer one */
+	if (r2chan->pass_depth++) {
+		return 0;
+	}
+	openr2_timerclear(&r2chan->pass_wallclock);
+	if (now) {
+		r2chan->pass_time = *now;
+	} else if (openr2_context_get_time(r2chan->r2context, &r2chan->pass_time)) {
+		r2chan->pass_depth--;
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Yikes! failed to get the current time, we may miss events!!\n");
+		return -1;
+	}
+	return 0;
+}
+
+#define openr2_chan_end_pass(r2chan) (r2chan)->pass_depth--
+
+/* order of dispatch for timers, earliest first and then in the order they were scheduled */
+#define openr2_sched_timer_before(a, b) \
+	(openr2_timercmp(&(a)->time, &(b)->time, <) || \
+	 (openr2_timercmp(&(a)->time, &(b)->time, ==) && (a)->id < (b)->id))
+
 /*! \brief must be called with chan lock held */
 static int openr2_chan_handle_timers(openr2_chan_t *r2chan)
 {
 	struct timeval nowtv;
 	openr2_sched_timer_t to_dispatch[OR2_MAX_SCHED_TIMERS];
-	int res, ms, t, i, timerid;
+	int res, t, i, d, timerid;
 
-	res = gettimeofday(&nowtv, NULL);
+	if (!r2chan->timers_count) {
+		return 0;
+	}
+
+	res = openr2_chan_get_time(r2chan, &nowtv);
 	if (res == -1) {
-		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Yikes! gettimeofday failed, me may miss events!!\n");
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Yikes! failed to get the current time, we may miss events!!\n");
 		return -1;
 	}
 	i = 0;
 
 	/* get the timers to dispatch */
-	for (t = 0; t < r2chan->timers_count; t++) {
-		ms = ((r2chan->sched_timers[t].time.tv_sec - nowtv.tv_sec) * 1000) +
-		     ((r2chan->sched_timers[t].time.tv_usec - nowtv.tv_usec)/1000);
-		if (ms <= 0) {
-			memcpy(&to_dispatch[i], &r2chan->sched_timers[t], sizeof(to_dispatch[0]));
+	for (t = 0; t < OR2_MAX_SCHED_TIMERS; t++) {
+		if (!r2chan->sched_timers[t].id) {
+			continue;
+		}
+		if (openr2_timer_due(&r2chan->sched_timers[t].time, &nowtv)) {
+			/* slots are not ordered, keep the dispatch list sorted */
+			for (d = i; d > 0 && openr2_sched_timer_before(&r2chan->sched_timers[t], &to_dispatch[d-1]); d--) {
+				memcpy(&to_dispatch[d], &to_dispatch[d-1], sizeof(to_dispatch[0]));
+			}
+			memcpy(&to_dispatch[d], &r2chan->sched_timers[t], sizeof(to_dispatch[0]));
 			i++;
 		}	
 	}
@@ -304,36 +364,108 @@ static int openr2_chan_handle_timers(openr2_chan_t *r2chan)
 	return 0;
 }
 
-OR2_DECLARE(int) openr2_chan_run_schedule(openr2_chan_t *r2chan)
+/*! \brief run the expired timers of the channel, now is the clock snapshot to use or NULL to read the clock */
+int openr2_chan_run_timers(openr2_chan_t *r2chan, const struct timeval *now)
 {
 	int ret = 0;
 	openr2_chan_lock(r2chan);
-	ret = openr2_chan_handle_timers(r2chan);
+	ret = openr2_chan_begin_pass(r2chan, now);
+	if (!ret) {
+		ret = openr2_chan_handle_timers(r2chan);
+		openr2_chan_end_pass(r2chan);
+	}
 	openr2_chan_unlock(r2chan);
 	return ret;
 }
 
+OR2_DECLARE(int) openr2_chan_run_schedule(openr2_chan_t *r2chan)
+{
+	return openr2_chan_run_timers(r2chan, NULL);
+}
+
+/* transcode a whole buffer, in one go if the transcoder can do it */
+static void openr2_chan_alaw_to_linear(openr2_chan_t *r2chan, const uint8_t alaw[], int16_t linear[], int samples)
+{
+	int i;
+	if (r2chan->r2context->alaw_to_linear_n) {
+		r2chan->r2context->alaw_to_linear_n(alaw, linear, samples);
+		return;
+	}
+	for (i = 0; i < samples; i++) {
+		linear[i] = TI(r2chan)->alaw_to_linear(alaw[i]);
+	}
+}
+
+static void openr2_chan_linear_to_alaw(openr2_chan_t *r2chan, const int16_t linear[], uint8_t alaw[], int samples)
+{
+	int i;
+	if (r2chan->r2context->linear_to_alaw_n) {
+		r2chan->r2context->linear_to_alaw_n(linear, alaw, samples);
+		return;
+	}
+	for (i = 0; i < samples; i++) {
+		alaw[i] = TI(r2chan)->linear_to_alaw(linear[i]);
+	}
+}
+
+/* Move the MF threshold clock to the end of the res samples read after samples_base.
+ * With no samples (res = 0) the hardware is detecting the tones, so the time of the
+ * context clock since the last update is counted instead, at 8 samples per ms */
+static void openr2_chan_mf_rx_clock(openr2_chan_t *r2chan, uint32_t samples_base, int res)
+{
+	struct timeval now;
+	long long usec;
+
+	r2chan->mf_rx_samples = samples_base + res;
+	if (!r2chan->r2context->mf_threshold || openr2_chan_get_time(r2chan, &now)) {
+		return;
+	}
+	if (res || (!r2chan->mf_rx_time.tv_sec && !r2chan->mf_rx_time.tv_usec)) {
+		r2chan->mf_rx_time = now;
+		return;
+	}
+	usec = ((long long)now.tv_sec - r2chan->mf_rx_time.tv_sec) * 1000000 + (now.tv_usec - r2chan->mf_rx_time.tv_usec);
+	if (usec < 125) {
+		return;
+	}
+	/* whole samples only, what is left over counts on the next update */
+	r2chan->mf_rx_samples += (uint32_t)(usec / 125);
+	usec = r2chan->mf_rx_time.tv_usec + (usec / 125) * 125;
+	r2chan->mf_rx_time.tv_sec += usec / 1000000;
+	r2chan->mf_rx_time.tv_usec = usec % 1000000;
+}
+
 /* Note that this function can be called with an IO empty buffer (res = 0), which means
  * hardware is taking care of the IO and we must just call the tone detection callbacks, etc
  * but we don't have any media to transcode or anything */
 static int openr2_chan_handle_media(openr2_chan_t *r2chan, uint8_t *read_buf, int res)
 {
-	unsigned i;
 	int tone_result = 0;
+	int native_rx = 0;
+	int nevents, i;
+	uint32_t samples_base = r2chan->mf_rx_samples;
+	openr2_mf_rx_event_t events[OR2_CHAN_READ_SIZE + 1];
 	int16_t tone_buf[OR2_CHAN_READ_SIZE];
 	/* if the DTMF or MF detector is enabled, we are supposed to detect tones */
 	if (r2chan->mf_state != OR2_MF_OFF_STATE) {
-		if (res) {
+#ifndef OR2_MF_DEBUG
+		/* the built-in detectors decode the A-law samples themselves, no need for tone_buf */
+		native_rx = r2chan->detecting_dtmf ? openr2_context_native_dtmf(r2chan->r2context)
+		                                   : openr2_context_native_mf(r2chan->r2context);
+#endif
+		if (res && !native_rx) {
 			/* assuming ALAW codec */
-			for (i = 0; i < (uint32_t) res; i++) {
-				tone_buf[i] = TI(r2chan)->alaw_to_linear(read_buf[i]);
-			}
+			openr2_chan_alaw_to_linear(r2chan, read_buf, tone_buf, res);
 #ifdef OR2_MF_DEBUG
 			write(r2chan->mf_read_fd, tone_buf, res*2);
 #endif
 		}
 		if (r2chan->detecting_dtmf) {
-			DTMF(r2chan)->dtmf_rx(r2chan->dtmf_read_handle, tone_buf, res);
+			if (native_rx) {
+				openr2_dtmf_rx_alaw(r2chan->dtmf_read_handle, read_buf, res);
+			} else {
+				DTMF(r2chan)->dtmf_rx(r2chan->dtmf_read_handle, tone_buf, res);
+			}
 			res = DTMF(r2chan)->dtmf_rx_status(r2chan->dtmf_read_handle);
 			if (!res) {
 				r2chan->dtmf_silence_samples += OR2_CHAN_READ_SIZE;
@@ -344,8 +476,21 @@ static int openr2_chan_handle_media(openr2_chan_t *r2chan, uint8_t *read_buf, in
 				}
 			}
 		} else {
-			tone_result = MFI(r2chan)->mf_detect_tone(r2chan->mf_read_handle, tone_buf, res);
-			if ( tone_result != -1 ) {
+			if (native_rx) {
+				/* hand over every tone change in order, stamped with the sample it was detected at */
+				nevents = openr2_mf_rx_alaw_events(r2chan->mf_read_handle, read_buf, res, events, OR2_CHAN_READ_SIZE + 1);
+				for (i = 0; i < nevents && r2chan->mf_state != OR2_MF_OFF_STATE; i++) {
+					r2chan->mf_rx_samples = samples_base + events[i].sample + 1;
+					openr2_proto_handle_mf_tone(r2chan, events[i].digit);
+				}
+				tone_result = openr2_mf_rx_get_digit(r2chan->mf_read_handle);
+			} else {
+				tone_result = MFI(r2chan)->mf_detect_tone(r2chan->mf_read_handle, tone_buf, res);
+			}
+			/* and the tone as of the end of the samples, this is what lets a tone
+			   that was held back by the MF threshold be handled once it lasted enough */
+			openr2_chan_mf_rx_clock(r2chan, samples_base, res);
+			if ( tone_result != -1 && r2chan->mf_state != OR2_MF_OFF_STATE ) {
 				openr2_proto_handle_mf_tone(r2chan, tone_result);
 			}
 		}
@@ -357,6 +502,67 @@ done:
 	return 0;
 }
 
+/* execute the commands posted by other threads, called with the channel lock held */
+static void openr2_chan_run_commands(openr2_chan_t *r2chan)
+{
+	openr2_chan_command_node_t *node, *next, *fifo = NULL;
+	openr2_chan_command_t *cmd;
+	int res = 0;
+
+	/* grab the whole queue at once */
+	do {
+		node = r2chan->command_queue;
+	} while (node && !openr2_atomic_cas_ptr(&r2chan->command_queue, node, NULL));
+
+	/* nodes were pushed in LIFO order, reverse them to execute in posting order */
+	while (node) {
+		next = node->next;
+		node->next = fifo;
+		fifo = node;
+		node = next;
+	}
+
+	for (node = fifo; node; node = next) {
+		next = node->next;
+		cmd = &node->command;
+		switch (cmd->type) {
+		case OR2_CMD_MAKE_CALL:
+			res = openr2_chan_make_call(r2chan, cmd->args.make_call.ani, cmd->args.make_call.dnis,
+					cmd->args.make_call.category, cmd->args.make_call.ani_restricted);
+			break;
+		case OR2_CMD_ACCEPT_CALL:
+			res = openr2_chan_accept_call(r2chan, cmd->args.accept_mode);
+			break;
+		case OR2_CMD_ANSWER_CALL:
+			res = openr2_chan_answer_call(r2chan);
+			break;
+		case OR2_CMD_ANSWER_CALL_WITH_MODE:
+			res = openr2_chan_answer_call_with_mode(r2chan, cmd->args.answer_mode);
+			break;
+		case OR2_CMD_DISCONNECT_CALL:
+			res = openr2_chan_disconnect_call(r2chan, cmd->args.disconnect_cause);
+			break;
+		case OR2_CMD_ACK_CALL:
+			res = openr2_chan_ack_call(r2chan);
+			break;
+		case OR2_CMD_SET_IDLE:
+			res = openr2_chan_set_idle(r2chan);
+			break;
+		case OR2_CMD_SET_BLOCKED:
+			res = openr2_chan_set_blocked(r2chan);
+			break;
+		default:
+			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Ignoring unknown posted command %d\n", cmd->type);
+			res = 0;
+			break;
+		}
+		if (res) {
+			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_WARNING, "Posted command %d failed\n", cmd->type);
+		}
+		openr2_free(node);
+	}
+}
+
 /*! \brief simple mask to determine what the user wants to process */
 #define OR2_CHAN_PROCESS_OOB (1 << 0)
 #define OR2_CHAN_PROCESS_MF (1 << 1)
@@ -364,33 +570,25 @@ done:
 #define HANDLE_IO_WRITE_RESULT(wrote) \
 			if (!wrote) { \
 				openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "No bytes written to channel %d when %d bytes were requested\n", r2chan->number, res); \
-				goto done; \
+				return 0; \
 			} \
 			if (wrote == -1) { \
-				retcode = -1; \
-				goto done; \
+				return -1; \
 			} \
 			if (wrote != res) { \
 				openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Just wrote %d bytes to channel %d when %d bytes were requested\n", wrote, r2chan->number, res); \
 			}
 
-/*! \brief main processing of signaling to check for incoming events, respond to them and dispatch user events */
-static int openr2_chan_process(openr2_chan_t *r2chan, int processing_mask)
+/*! \brief I/O events the channel is interested in given what the user wants to process */
+static int openr2_chan_wanted_events(openr2_chan_t *r2chan, int processing_mask)
 {
-	unsigned i;
-	int interesting_events, res, wrote;
-	openr2_oob_event_t event;
-	uint8_t read_buf[OR2_CHAN_READ_SIZE];
-	int16_t tone_buf[OR2_CHAN_READ_SIZE];
-	/* just one return point in this function, set retcode and call goto done when done */
-	int retcode = 0;
-
-	openr2_chan_lock(r2chan);
-	openr2_chan_handle_timers(r2chan);
-
-tryagain:
 	/* check for CAS and ALARM events only if requested */
-	interesting_events = (processing_mask & OR2_CHAN_PROCESS_OOB) ? OR2_IO_OOB_EVENT : 0;
+	int interesting_events = (processing_mask & OR2_CHAN_PROCESS_OOB) ? OR2_IO_OOB_EVENT : 0;
+
+	/* if we're in alarm, ignore any other events and just poll for OOB */
+	if (r2chan->inalarm) {
+		return OR2_IO_OOB_EVENT;
+	}
 
 	/* we also want to be notified about read-ready if we have read enabled and the user requested MF processing */
 	if (r2chan->read_enabled && (processing_mask & OR2_CHAN_PROCESS_MF)) {
@@ -408,85 +606,235 @@ tryagain:
 		interesting_events |= OR2_IO_WRITE;
 	}
 
-	if (r2chan->inalarm) {
-		/* if we're in alarm, clear any other events and just poll for OOB */
-		interesting_events = OR2_IO_OOB_EVENT;
-	}
+	return interesting_events;
+}
 
-	/* ask the I/O layer to poll for the requested events immediately, no blocking */
-	res = openr2_io_wait(r2chan, &interesting_events, 0);
-	if (res) {
-		retcode = -1;
-		goto done;
-	}
+/*! \brief I/O events the channel wants to be processed for, must be called with the chan lock held */
+int openr2_chan_get_wanted_events(openr2_chan_t *r2chan)
+{
+	return openr2_chan_wanted_events(r2chan, OR2_CHAN_PROCESS_MF | OR2_CHAN_PROCESS_OOB);
+}
 
-	/* if there is no interesting events, do nothing */
-	if (!interesting_events) {
-		retcode = 0;
-		goto done;
-	}
+/*! \brief handle the given ready I/O events once. Returns 1 if there may be more to
+ * do right away, 0 if there is nothing else to do and -1 on error */
+static int openr2_chan_handle_io(openr2_chan_t *r2chan, int events)
+{
+	int res, wrote;
+	int encoded_tx = 0;
+	openr2_oob_event_t event;
+	uint8_t read_buf[OR2_CHAN_READ_SIZE];
+	int16_t tone_buf[OR2_CHAN_READ_SIZE];
 
 	/* if there is an OOB event, probably CAS bits just changed */
-	if (OR2_IO_OOB_EVENT & interesting_events) {
+	if (OR2_IO_OOB_EVENT & events) {
 		res = openr2_io_get_oob_event(r2chan, &event);
 		if (!res && event != OR2_OOB_EVENT_NONE) {
 			openr2_chan_handle_oob_event(r2chan, event);
 		}
 	}
 
-	if (r2chan->read_enabled && (OR2_IO_READ & interesting_events)) {
+	if (r2chan->read_enabled && (OR2_IO_READ & events)) {
 		res = openr2_io_read(r2chan, read_buf, sizeof(read_buf));
 		if (-1 == res) {
-			retcode = -1;
-			goto done;
+			return -1;
 		}
 		if (!res) {
 			/* if nothing was read, continue, may be there is a priority event (ie DAHDI read ELAST) */
-			goto tryagain;
+			return 1;
 		}
 		openr2_chan_handle_media(r2chan, read_buf, res);
 	}
 
 	/* we only write MF or DTMF tones here. Speech write is responsibility of the user, she should call openr2_chan_write for that */
-	if (r2chan->dialing_dtmf && (OR2_IO_WRITE & interesting_events)) {
-		res = DTMF(r2chan)->dtmf_tx(r2chan->dtmf_write_handle, tone_buf, r2chan->io_buf_size);
+	if (r2chan->dialing_dtmf && (OR2_IO_WRITE & events)) {
+		/* generators able to hand out A-law samples write straight from read_buf */
+		encoded_tx = r2chan->r2context->dtmf_tx_alaw ? 1 : 0;
+		if (encoded_tx) {
+			res = r2chan->r2context->dtmf_tx_alaw(r2chan->dtmf_write_handle, read_buf, r2chan->io_buf_size);
+		} else {
+			res = DTMF(r2chan)->dtmf_tx(r2chan->dtmf_write_handle, tone_buf, r2chan->io_buf_size);
+		}
 		if (res <= 0) {
 			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_DEBUG, "Done with DTMF generation\n");
 			openr2_proto_handle_dtmf_end(r2chan);
-			goto tryagain;
+			return 1;
 		}
-		for (i = 0; i < (uint32_t) res; i++) {
-			read_buf[i] = TI(r2chan)->linear_to_alaw(tone_buf[i]);
+		if (!encoded_tx) {
+			openr2_chan_linear_to_alaw(r2chan, tone_buf, read_buf, res);
 		}
 		wrote = openr2_io_write(r2chan, read_buf, res);
 		HANDLE_IO_WRITE_RESULT(wrote);
 	} else if ((OR2_MF_OFF_STATE != r2chan->mf_state) &&
-			(OR2_IO_WRITE & interesting_events)) {
-		res = MFI(r2chan)->mf_generate_tone(r2chan->mf_write_handle, tone_buf, r2chan->io_buf_size);
+			(OR2_IO_WRITE & events)) {
+#ifndef OR2_MF_DEBUG
+		encoded_tx = r2chan->r2context->mf_generate_alaw ? 1 : 0;
+#endif
+		if (encoded_tx) {
+			res = r2chan->r2context->mf_generate_alaw(r2chan->mf_write_handle, read_buf, r2chan->io_buf_size);
+		} else {
+			res = MFI(r2chan)->mf_generate_tone(r2chan->mf_write_handle, tone_buf, r2chan->io_buf_size);
+		}
 		/* if there are no samples to convert and write then continue,
 		   the generate routine already took care of it */
 		if (!res) {
-			goto tryagain;
+			return 1;
 		}
 		/* an error on tone generation, lets just bail out and hope for the best */
 		if (-1 == res) {
 			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to generate MF tone.\n");
-			retcode = -1;
-			goto done;
+			return -1;
 		}
 #ifdef OR2_MF_DEBUG
 		write(r2chan->mf_write_fd, tone_buf, res*2);
 #endif
-		for (i = 0; i < (uint32_t) res; i++) {
-			read_buf[i] = TI(r2chan)->linear_to_alaw(tone_buf[i]);
+		if (!encoded_tx) {
+			openr2_chan_linear_to_alaw(r2chan, tone_buf, read_buf, res);
 		}
 		wrote = openr2_io_write(r2chan, read_buf, res);
 		HANDLE_IO_WRITE_RESULT(wrote);
 	}
 
-	goto tryagain;
+	return 1;
+}
+
+/*! \brief main processing of signaling to check for incoming events, respond to them and dispatch user events */
+static int openr2_chan_process(openr2_chan_t *r2chan, int processing_mask)
+{
+	int interesting_events, res;
+	/* just one return point in this function, set retcode and call goto done when done */
+	int retcode = 0;
+
+	openr2_chan_lock(r2chan);
+	if (openr2_chan_begin_pass(r2chan, NULL)) {
+		openr2_chan_unlock(r2chan);
+		return -1;
+	}
+	if (r2chan->command_queue) {
+		openr2_chan_run_commands(r2chan);
+	}
+	openr2_chan_handle_timers(r2chan);
+
+	for ( ; ; ) {
+		interesting_events = openr2_chan_wanted_events(r2chan, processing_mask);
+
+		/* ask the I/O layer to poll for the requested events immediately, no blocking */
+		res = openr2_io_wait(r2chan, &interesting_events, 0);
+		if (res) {
+			retcode = -1;
+			goto done;
+		}
+
+		/* if there is no interesting events, do nothing */
+		if (!interesting_events) {
+			retcode = 0;
+			goto done;
+		}
+
+		res = openr2_chan_handle_io(r2chan, interesting_events);
+		if (res <= 0) {
+			retcode = res;
+			goto done;
+		}
+	}
 
 done:
+	openr2_chan_end_pass(r2chan);
+	openr2_chan_unlock(r2chan);
+	return retcode;
+}
+
+/*! \brief process the I/O events the caller already knows the channel is ready for, without
+ * polling the device. The clock snapshot of the pass is provided by the caller and timers are
+ * not run, the caller is expected to sweep them once for all the channels it processes */
+int openr2_chan_process_ready(openr2_chan_t *r2chan, int events, const struct timeval *now)
+{
+	int retcode = 0;
+
+	openr2_chan_lock(r2chan);
+	if (openr2_chan_begin_pass(r2chan, now)) {
+		openr2_chan_unlock(r2chan);
+		return -1;
+	}
+	if (r2chan->command_queue) {
+		openr2_chan_run_commands(r2chan);
+	}
+
+	/* readiness for events we are not interested in right now is ignored */
+	events &= openr2_chan_wanted_events(r2chan, OR2_CHAN_PROCESS_MF | OR2_CHAN_PROCESS_OOB);
+	if (events && -1 == openr2_chan_handle_io(r2chan, events)) {
+		retcode = -1;
+	}
+
+	openr2_chan_end_pass(r2chan);
+	openr2_chan_unlock(r2chan);
+	return retcode;
+}
+
+/* must be called with the channel lock held */
+static int openr2_chan_time_to_next_timer(openr2_chan_t *r2chan)
+{
+	int res, i;
+	struct timeval currtime;
+	openr2_sched_timer_t *next = NULL;
+	int myerrno;
+
+	/* if no timers, return 'infinite' */
+	if (!r2chan->timers_count) {
+		return -1;
+	}
+
+	res = openr2_chan_get_time(r2chan, &currtime);
+	if (-1 == res) {
+		myerrno = errno;
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to get next event from channel. Cannot get the current time!\n");
+		EMI(r2chan)->on_os_error(r2chan, myerrno);
+		return -1;
+	}
+
+	for (i = 0; i < OR2_MAX_SCHED_TIMERS; i++) {
+		if (r2chan->sched_timers[i].id && (!next || openr2_timercmp(&r2chan->sched_timers[i].time, &next->time, <))) {
+			next = &r2chan->sched_timers[i];
+		}
+	}
+	if (!next) {
+		return -1;
+	}
+
+	return openr2_timer_wait_ms(&next->time, &currtime);
+}
+
+OR2_DECLARE(int) openr2_chan_step(openr2_chan_t *r2chan, int io_events_in, int *io_events_wanted, int *next_deadline_ms)
+{
+	int retcode = 0;
+
+	openr2_chan_lock(r2chan);
+	if (openr2_chan_begin_pass(r2chan, NULL)) {
+		openr2_chan_unlock(r2chan);
+		return -1;
+	}
+	if (r2chan->command_queue) {
+		openr2_chan_run_commands(r2chan);
+	}
+
+	if (-1 == openr2_chan_handle_timers(r2chan)) {
+		retcode = -1;
+	}
+
+	/* the caller already knows what the device is ready for, never poll nor wait on it here */
+	io_events_in &= openr2_chan_wanted_events(r2chan, OR2_CHAN_PROCESS_MF | OR2_CHAN_PROCESS_OOB);
+	if (io_events_in && -1 == openr2_chan_handle_io(r2chan, io_events_in)) {
+		retcode = -1;
+	}
+
+	/* the timers and events may have changed the state, report what the channel needs from now on */
+	if (io_events_wanted) {
+		*io_events_wanted = openr2_chan_wanted_events(r2chan, OR2_CHAN_PROCESS_MF | OR2_CHAN_PROCESS_OOB);
+	}
+	if (next_deadline_ms) {
+		*next_deadline_ms = openr2_chan_time_to_next_timer(r2chan);
+	}
+
+	openr2_chan_end_pass(r2chan);
 	openr2_chan_unlock(r2chan);
 	return retcode;
 }
@@ -515,63 +863,64 @@ int openr2_chan_add_timer(openr2_chan_t *r2chan, int ms, openr2_callback_t callb
 {
 	int myerrno;
 	struct timeval tv;
-	openr2_sched_timer_t newtimer;
+	openr2_sched_timer_t *newtimer;
+	openr2_timer_shard_t *shard = r2chan->timer_shard;
 	int res;
 	int i;
 
-	openr2_mutex_lock(r2chan->r2context->timers_lock);
+	openr2_mutex_lock(shard->lock);
 
-	res = gettimeofday(&tv, NULL);
+	res = openr2_chan_get_time(r2chan, &tv);
 	if (-1 == res) {
 		myerrno = errno;
 
-		openr2_mutex_unlock(r2chan->r2context->timers_lock);
+		openr2_mutex_unlock(shard->lock);
 
-		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to get time of day to schedule timer!!");
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to get the current time to schedule timer!!");
 		EMI(r2chan)->on_os_error(r2chan, myerrno);
 		return -1;
 	}
 	if (r2chan->timers_count == OR2_MAX_SCHED_TIMERS) {
 
-		openr2_mutex_unlock(r2chan->r2context->timers_lock);
+		openr2_mutex_unlock(shard->lock);
 
 		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "No more time slots, failed to schedule timer, this is bad!\n");
 		return -1;
 	}
+	/* find a free slot for the timer */
+	for (i = 0; r2chan->sched_timers[i].id; i++);
+	newtimer = &r2chan->sched_timers[i];
 	/* build the new timer */
-	newtimer.time.tv_sec = tv.tv_sec + (ms / 1000);
-	newtimer.time.tv_usec = tv.tv_usec + (ms % 1000) * 1000;
+	newtimer->time.tv_sec = tv.tv_sec + (ms / 1000);
+	newtimer->time.tv_usec = tv.tv_usec + (ms % 1000) * 1000;
 	/* more than 1000000 microseconds, then increment one second */
-	 if (newtimer.time.tv_usec > 1000000) {
-		 newtimer.time.tv_sec += 1;
-		 newtimer.time.tv_usec -= 1000000;
-	}
-	newtimer.callback = callback;
-	newtimer.name = name;
-	newtimer.id = ++r2chan->timer_id;
-	/* find the proper slot for the timer */
-	for (i = 0; i < r2chan->timers_count; i++) {
-		if (openr2_timercmp(&newtimer.time, &r2chan->sched_timers[i].time, <)) {
-			memmove(&r2chan->sched_timers[i+1], 
-				&r2chan->sched_timers[i], 
-				(r2chan->timers_count-i) * sizeof(r2chan->sched_timers[0]));
-			memcpy(&r2chan->sched_timers[i], &newtimer, sizeof(newtimer));
-			break;
-		}
+	 if (newtimer->time.tv_usec > 1000000) {
+		 newtimer->time.tv_sec += 1;
+		 newtimer->time.tv_usec -= 1000000;
 	}
-	/* this means the new timer will be triggered at the end */
-	if (i == r2chan->timers_count) {
-		memcpy(&r2chan->sched_timers[i], &newtimer, sizeof(newtimer));
+	newtimer->callback = callback;
+	newtimer->name = name;
+	newtimer->r2chan = r2chan;
+	newtimer->id = ++r2chan->timer_id;
+	/* let the context schedule know about it */
+	if (openr2_timer_shard_add(shard, newtimer)) {
+		memset(newtimer, 0, sizeof(*newtimer));
+
+		openr2_mutex_unlock(shard->lock);
+
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to allocate memory to schedule timer, this is bad!\n");
+		return -1;
 	}
 	r2chan->timers_count++;
 
-	openr2_mutex_unlock(r2chan->r2context->timers_lock);
-	openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_EX_DEBUG, "scheduled timer id %d (%s)\n", newtimer.id, newtimer.name);
-	return newtimer.id;
+	openr2_mutex_unlock(shard->lock);
+	openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_EX_DEBUG, "scheduled timer id %d (%s)\n", newtimer->id, newtimer->name);
+	return newtimer->id;
 }
 
 void openr2_chan_cancel_timer(openr2_chan_t *r2chan, int *timer_id)
 {
+	openr2_timer_shard_t *shard = r2chan->timer_shard;
 	int i = 0;
 	openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_EX_DEBUG, "Attempting to cancel timer %d\n", *timer_id);
 	if (*timer_id < 1) {
@@ -579,45 +928,68 @@ void openr2_chan_cancel_timer(openr2_chan_t *r2chan, int *timer_id)
 		return;
 	}
 
-	openr2_mutex_lock(r2chan->r2context->timers_lock);
+	openr2_mutex_lock(shard->lock);
 
-	for ( ; i < r2chan->timers_count; i++) {
+	for ( ; i < OR2_MAX_SCHED_TIMERS; i++) {
 		if (r2chan->sched_timers[i].id == *timer_id) {
 			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_EX_DEBUG, "timer id %d found, cancelling it now\n", *timer_id);
-			/* clear the timer and move down the list */
+			/* take it out of the context schedule and free the slot */
+			openr2_timer_shard_remove(shard, &r2chan->sched_timers[i]);
 			memset(&r2chan->sched_timers[i], 0, sizeof(r2chan->sched_timers[0]));
-			if (i < (r2chan->timers_count - 1)) {
-				memmove(&r2chan->sched_timers[i], &r2chan->sched_timers[i+1], 
-				       (r2chan->timers_count - (i + 1))*sizeof(r2chan->sched_timers[0]));
-			}
 			r2chan->timers_count--;
 			*timer_id = 0;
 			break;
 		}
 	}
 
-	openr2_mutex_unlock(r2chan->r2context->timers_lock);
+	openr2_mutex_unlock(shard->lock);
 }
 
 void openr2_chan_cancel_all_timers(openr2_chan_t *r2chan)
 {
-	openr2_mutex_lock(r2chan->r2context->timers_lock);
+	openr2_timer_shard_t *shard = r2chan->timer_shard;
+	int i;
 
+	/* channels that never made it into the context have no timers */
+	if (!shard) {
+		return;
+	}
+
+	openr2_mutex_lock(shard->lock);
+
+	for (i = 0; i < OR2_MAX_SCHED_TIMERS; i++) {
+		if (r2chan->sched_timers[i].id) {
+			openr2_timer_shard_remove(shard, &r2chan->sched_timers[i]);
+		}
+	}
 	r2chan->timers_count = 0;
 	r2chan->timer_id = 1;
 	memset(&r2chan->timer_ids, 0, sizeof(r2chan->timer_ids));
 	memset(r2chan->sched_timers, 0, sizeof(r2chan->sched_timers));
 
-	openr2_mutex_unlock(r2chan->r2context->timers_lock);
+	openr2_mutex_unlock(shard->lock);
 }
 
 OR2_DECLARE(void) openr2_chan_delete(openr2_chan_t *r2chan)
 {
+	openr2_chan_command_node_t *node;
+
+	/* stop being part of the context (its reactor and schedule), this waits for
+	   the context thread serving the channel to be done with it and cancels the timers */
+	openr2_context_remove_channel(r2chan->r2context, r2chan);
+
 	openr2_chan_lock(r2chan);
 
 	/* let know the protocol layer this channel is going down */
 	openr2_proto_destroy(r2chan);
 
+	/* commands nobody will execute */
+	while (r2chan->command_queue) {
+		node = r2chan->command_queue;
+		r2chan->command_queue = node->next;
+		openr2_free(node);
+	}
+
 	if (r2chan->fd_created) {
 		openr2_io_close(r2chan);
 	}
@@ -794,6 +1166,22 @@ OR2_DECLARE(int) openr2_chan_ack_call(openr2_chan_t *r2chan)
 	return retcode;
 }
 
+OR2_DECLARE(int) openr2_chan_post_command(openr2_chan_t *r2chan, const openr2_chan_command_t *command)
+{
+	openr2_chan_command_node_t *node = openr2_malloc(sizeof(*node));
+	if (!node) {
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to allocate memory for posted command\n");
+		return -1;
+	}
+	memcpy(&node->command, command, sizeof(node->command));
+	do {
+		node->next = r2chan->command_queue;
+	} while (!openr2_atomic_cas_ptr(&r2chan->command_queue, node->next, node));
+	/* let the context reactor know there is work for this channel */
+	openr2_context_wakeup(r2chan->r2context, r2chan);
+	return 0;
+}
+
 OR2_DECLARE(int) openr2_chan_write(openr2_chan_t *r2chan, const unsigned char *buf, int buf_size)
 {
 	int myerrno;
@@ -864,40 +1252,11 @@ OR2_DECLARE(void *) openr2_chan_get_client_data(openr2_chan_t *r2chan)
 
 OR2_DECLARE(int) openr2_chan_get_time_to_next_event(openr2_chan_t *r2chan)
 {
-	int res, ms;
-	struct timeval currtime;
-	int myerrno;
-	ms = -1;
-
-	openr2_chan_lock(r2chan);	
-	openr2_mutex_lock(r2chan->r2context->timers_lock);
-
-	/* if no timers, return 'infinite' */
-	if (!r2chan->timers_count) {
-		ms = -1;
-		goto done;
-	}
-
-	res = gettimeofday(&currtime, NULL);
+	int ms;
 
-	if (-1 == res) {
-		myerrno = errno;
-		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to get next event from channel. gettimeofday failed!\n");
-		EMI(r2chan)->on_os_error(r2chan, myerrno);
-		ms = -1;
-		goto done;
-	}
-
-	ms = (((r2chan->sched_timers[0].time.tv_sec - currtime.tv_sec) * 1000) + 
-	     ((r2chan->sched_timers[0].time.tv_usec - currtime.tv_usec) / 1000));
-
-	if (ms < 0) {
-		ms = 0;
-	}	
-
-done:
-
-	openr2_mutex_unlock(r2chan->r2context->timers_lock);
+	/* the timer slots of the channel only change with the channel lock held */
+	openr2_chan_lock(r2chan);
+	ms = openr2_chan_time_to_next_timer(r2chan);
 	openr2_chan_unlock(r2chan);
 
 	return ms;
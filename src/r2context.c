@@ -28,6 +28,9 @@
 #include "config.h"
 #endif
 
+/* must go first so the system headers see our feature macros */
+#include "openr2/r2declare.h"
+
 #include <string.h>
 #include <fcntl.h>
 #include <stdlib.h>
@@ -41,7 +44,14 @@
 #include <sys/types.h>
 #endif
 #include <sys/stat.h>
+#include <time.h>
 #include <errno.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
 #include "openr2/r2declare.h"
 #include "openr2/r2thread.h"
 #include "openr2/r2engine.h"
@@ -206,9 +216,13 @@ static openr2_dtmf_interface_t default_dtmf_engine = {
 	/* .dtmf_rx */ (openr2_dtmf_rx_func)openr2_dtmf_rx
 };
 
+static int openr2_timer_shard_init(openr2_timer_shard_t *shard, openr2_context_t *r2context, openr2_worker_t *worker);
+static void openr2_timer_shard_destroy(openr2_timer_shard_t *shard);
+
 OR2_DECLARE(openr2_context_t *) openr2_context_new(openr2_variant_t variant, openr2_event_interface_t *evmanager, int max_ani, int max_dnis)
 {
 	openr2_context_t *r2context = NULL;
+	int i;
 	if (!evmanager) {
 		evmanager = &default_evmanager;
 	} else {
@@ -275,21 +289,51 @@ OR2_DECLARE(openr2_context_t *) openr2_context_new(openr2_variant_t variant, ope
 	}
 
 	r2context->mflib = &default_mf_interface;
+	r2context->mf_generate_alaw = (openr2_mf_generate_alaw_func)openr2_mf_tx_alaw;
 	r2context->transcoder = &default_transcoder;
+	r2context->alaw_to_linear_n = openr2_alaw_to_linear_n;
+	r2context->linear_to_alaw_n = openr2_linear_to_alaw_n;
 	r2context->variant = variant;
 	r2context->evmanager = evmanager;
 	r2context->dtmfeng = &default_dtmf_engine;
+	r2context->dtmf_tx_alaw = (openr2_dtmf_tx_alaw_func)openr2_dtmf_tx_alaw;
+	r2context->mf_block = OR2_MF_RX_BLOCK_SAMPLES;
+	r2context->mf_hop = OR2_MF_RX_BLOCK_SAMPLES;
 	r2context->loglevel = OR2_LOG_ERROR | OR2_LOG_WARNING | OR2_LOG_NOTICE;
+	/* the reactor is created the first time is used */
+	r2context->reactor_fd = -1;
+	r2context->reactor_wakefd[0] = -1;
+	r2context->reactor_wakefd[1] = -1;
+	r2context->timer_fd = -1;
 	openr2_mutex_create(&r2context->timers_lock);
+	openr2_mutex_create(&r2context->reactor_lock);
+	for (i = 0; i < OR2_TIMER_SHARDS; i++) {
+		openr2_timer_shard_init(&r2context->timer_shards[i], r2context, NULL);
+	}
+	if (openr2_context_set_clock_source(r2context, OR2_CLOCK_MONOTONIC)) {
+		/* no monotonic clock in this platform */
+		r2context->clock_source = OR2_CLOCK_REALTIME;
+	}
+	/* MF tones are sent straight from the cache when there is one, not having it just costs CPU */
+	if (openr2_mf_tx_cache_init()) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_WARNING, "Failed to create the MF tone cache, tones will be synthesized\n");
+	}
 	if (openr2_proto_configure_context(r2context, variant, max_ani, max_dnis)) {
-		free(r2context);
-		return NULL;
+		goto failed;
 	}
 	if (openr2_context_set_io_type(r2context, OR2_IO_DEFAULT, NULL) == -1) {
-		free(r2context);
-		return NULL;
+		goto failed;
 	}
 	return r2context;
+
+failed:
+	for (i = 0; i < OR2_TIMER_SHARDS; i++) {
+		openr2_timer_shard_destroy(&r2context->timer_shards[i]);
+	}
+	openr2_mutex_destroy(&r2context->reactor_lock);
+	openr2_mutex_destroy(&r2context->timers_lock);
+	free(r2context);
+	return NULL;
 }
 
 OR2_DECLARE(int) openr2_context_set_mflib_interface(openr2_context_t *r2context, openr2_mflib_interface_t *mflib)
@@ -325,6 +369,17 @@ OR2_DECLARE(int) openr2_context_set_mflib_interface(openr2_context_t *r2context,
 	}
 	/* dispose routines are allowed to be NULL */
 	r2context->mflib = mflib;
+	/* the A-law generator must match, see openr2_context_set_mf_alaw_generator() */
+	r2context->mf_generate_alaw = NULL;
+	return 0;
+}
+
+/* A-law version of the mf_generate_tone() routine of the MF interface, NULL to generate linear
+   samples and transcode them. Kept apart from openr2_mflib_interface_t so the structure stays
+   the same for existing users. Setting an MF or a transcoder interface clears it */
+OR2_DECLARE(int) openr2_context_set_mf_alaw_generator(openr2_context_t *r2context, openr2_mf_generate_alaw_func mf_generate_alaw)
+{
+	r2context->mf_generate_alaw = mf_generate_alaw;
 	return 0;
 }
 
@@ -344,6 +399,22 @@ OR2_DECLARE(int) openr2_context_set_transcoder_interface(openr2_context_t *r2con
 		return -1;
 	}
 	r2context->transcoder = transcoder;
+	/* the whole buffer routines must match, see openr2_context_set_bulk_transcoder() */
+	r2context->alaw_to_linear_n = NULL;
+	r2context->linear_to_alaw_n = NULL;
+	/* and so must the A-law tone generators, or the tones would skip linear_to_alaw */
+	r2context->mf_generate_alaw = NULL;
+	r2context->dtmf_tx_alaw = NULL;
+	return 0;
+}
+
+/* Whole buffer versions of the transcoder routines, either may be NULL to transcode
+   sample by sample. They are kept apart from openr2_transcoder_interface_t so the structure
+   stays the same for existing users. Setting a transcoder interface clears them */
+OR2_DECLARE(int) openr2_context_set_bulk_transcoder(openr2_context_t *r2context, openr2_alaw_to_linear_n_func alaw_to_linear_n, openr2_linear_to_alaw_n_func linear_to_alaw_n)
+{
+	r2context->alaw_to_linear_n = alaw_to_linear_n;
+	r2context->linear_to_alaw_n = linear_to_alaw_n;
 	return 0;
 }
 
@@ -351,6 +422,7 @@ OR2_DECLARE(int) openr2_context_set_dtmf_interface(openr2_context_t *r2context,
 {
 	if (!dtmf_interface) {
 		r2context->dtmfeng = &default_dtmf_engine;
+		r2context->dtmf_tx_alaw = (openr2_dtmf_tx_alaw_func)openr2_dtmf_tx_alaw;
 		return 0;
 	}
 
@@ -380,103 +452,1172 @@ OR2_DECLARE(int) openr2_context_set_dtmf_interface(openr2_context_t *r2context,
 	}
 
 	r2context->dtmfeng = dtmf_interface;
+	/* the A-law generator must match, see openr2_context_set_dtmf_alaw_generator() */
+	r2context->dtmf_tx_alaw = NULL;
 	return 0;
 }
 
-/* Is this really needed? in anycase, read events from hardware are likely to wake us up
-   so probably we could trust on that instead of having the user to call this function? */
-OR2_DECLARE(int) openr2_context_get_time_to_next_event(openr2_context_t *r2context)
+/* A-law version of the dtmf_tx() routine of the DTMF interface, NULL to generate linear
+   samples and transcode them. Setting a DTMF or a transcoder interface clears it */
+OR2_DECLARE(int) openr2_context_set_dtmf_alaw_generator(openr2_context_t *r2context, openr2_dtmf_tx_alaw_func dtmf_tx_alaw)
+{
+	r2context->dtmf_tx_alaw = dtmf_tx_alaw;
+	return 0;
+}
+
+/* the built-in detectors can take the A-law samples as read and decode them on their
+   own, as long as neither the detector nor the transcoder have been replaced */
+int openr2_context_native_mf(openr2_context_t *r2context)
 {
-	int res, ms;
-	struct timeval currtime;
-	/* iterate over all the channels to get the next event time,
-	   during this loop, timers cannot be deleted or created */
-	openr2_chan_t *current = r2context->chanlist;
-	openr2_chan_t *winner = NULL;
+	return r2context->mflib == &default_mf_interface && r2context->transcoder == &default_transcoder;
+}
+
+int openr2_context_native_dtmf(openr2_context_t *r2context)
+{
+	return r2context->dtmfeng == &default_dtmf_engine && r2context->transcoder == &default_transcoder;
+}
+
+/* apply the MF detection block settings to a freshly initialized detector, only
+   the built-in one knows about them */
+void openr2_context_configure_mf_rx(openr2_context_t *r2context, void *mf_read_handle)
+{
+	if (r2context->mflib != &default_mf_interface) {
+		return;
+	}
+	openr2_mf_rx_set_block(mf_read_handle, r2context->mf_block, r2context->mf_hop);
+}
+
+int openr2_context_get_time(openr2_context_t *r2context, struct timeval *now)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+	if (r2context->clock_source != OR2_CLOCK_REALTIME) {
+		if (clock_gettime(r2context->clock_id, &ts)) {
+			return -1;
+		}
+		now->tv_sec = ts.tv_sec;
+		now->tv_usec = ts.tv_nsec / 1000;
+		return 0;
+	}
+#endif
+	return gettimeofday(now, NULL);
+}
+
+/* read the earliest deadline of the shard without taking its lock, returns 0 if there are no timers */
+static int openr2_timer_shard_get_earliest(openr2_timer_shard_t *shard, struct timeval *earliest)
+{
+	unsigned int seq;
+	int pending;
+	do {
+		seq = shard->seq;
+		openr2_atomic_barrier();
+		pending = shard->pending;
+		*earliest = shard->earliest;
+		openr2_atomic_barrier();
+	} while ((seq & 1) || seq != shard->seq);
+	return pending;
+}
+
+/* earliest deadline of a set of shards, returns 0 if there are no timers */
+static int openr2_context_get_earliest(openr2_timer_shard_t *shards, int count, struct timeval *earliest)
+{
+	struct timeval next;
+	int pending = 0;
+	int s;
+	for (s = 0; s < count; s++) {
+		if (!openr2_timer_shard_get_earliest(&shards[s], &next)) {
+			continue;
+		}
+		if (!pending || openr2_timercmp(&next, earliest, <)) {
+			*earliest = next;
+			pending = 1;
+		}
+	}
+	return pending;
+}
 
+OR2_DECLARE(int) openr2_context_set_clock_source(openr2_context_t *r2context, openr2_clock_source_t source)
+{
+	struct timeval earliest;
+#ifdef CLOCK_MONOTONIC
+	struct timespec res_ts;
+#endif
+	int res = 0;
 	openr2_mutex_lock(r2context->timers_lock);
+	/* scheduled timers would expire at the wrong time with a different clock */
+	if (openr2_context_get_earliest(r2context->timer_shards, OR2_TIMER_SHARDS, &earliest)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Cannot change the clock source with timers scheduled\n");
+		res = -1;
+		goto done;
+	}
+	if (r2context->workers) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Cannot change the clock source with workers running\n");
+		res = -1;
+		goto done;
+	}
+	switch (source) {
+	case OR2_CLOCK_REALTIME:
+		break;
+#ifdef CLOCK_MONOTONIC
+	case OR2_CLOCK_MONOTONIC:
+		r2context->clock_id = CLOCK_MONOTONIC;
+		break;
+	case OR2_CLOCK_MONOTONIC_COARSE:
+#ifdef CLOCK_MONOTONIC_COARSE
+		r2context->clock_id = CLOCK_MONOTONIC_COARSE;
+#else
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_NOTICE, "Coarse monotonic clock not available, using monotonic clock\n");
+		r2context->clock_id = CLOCK_MONOTONIC;
+#endif
+		break;
+#endif
+	default:
+		r2context->last_error = OR2_LIBERR_NOT_SUPPORTED;
+		res = -1;
+		goto done;
+	}
+	r2context->clock_source = source;
+	r2context->clock_lag_ns = 0;
+#ifdef CLOCK_MONOTONIC
+	/* the coarse clock only moves once per tick */
+	if (source != OR2_CLOCK_REALTIME && !clock_getres(r2context->clock_id, &res_ts) && res_ts.tv_sec == 0 && res_ts.tv_nsec > 1000) {
+		r2context->clock_lag_ns = res_ts.tv_nsec;
+	}
+#endif
+done:
+	openr2_mutex_unlock(r2context->timers_lock);
+	return res;
+}
 
-	res = gettimeofday(&currtime, NULL);
-	if (-1 == res) {
+OR2_DECLARE(openr2_clock_source_t) openr2_context_get_clock_source(openr2_context_t *r2context)
+{
+	return r2context->clock_source;
+}
+
+/* the heap must be accessed with the shard lock held */
+#define OR2_TIMERS_HEAP_MIN_SIZE 16
+#define OR2_TIMERS_HEAP_PARENT(i) (((i) - 1) / 2)
+#define OR2_TIMERS_HEAP_LEFT(i) ((2 * (i)) + 1)
+
+static void openr2_timer_shard_heap_set(openr2_timer_shard_t *shard, int i, openr2_sched_timer_t *timer)
+{
+	shard->heap[i] = timer;
+	timer->heap_index = i;
+}
+
+static void openr2_timer_shard_heap_up(openr2_timer_shard_t *shard, int i)
+{
+	openr2_sched_timer_t *timer = shard->heap[i];
+	while (i > 0 && openr2_timercmp(&timer->time, &shard->heap[OR2_TIMERS_HEAP_PARENT(i)]->time, <)) {
+		openr2_timer_shard_heap_set(shard, i, shard->heap[OR2_TIMERS_HEAP_PARENT(i)]);
+		i = OR2_TIMERS_HEAP_PARENT(i);
+	}
+	openr2_timer_shard_heap_set(shard, i, timer);
+}
+
+static void openr2_timer_shard_heap_down(openr2_timer_shard_t *shard, int i)
+{
+	openr2_sched_timer_t *timer = shard->heap[i];
+	int child;
+	while ((child = OR2_TIMERS_HEAP_LEFT(i)) < shard->len) {
+		/* pick the earliest child */
+		if ((child + 1) < shard->len && 
+		    openr2_timercmp(&shard->heap[child + 1]->time, &shard->heap[child]->time, <)) {
+			child++;
+		}
+		if (!openr2_timercmp(&shard->heap[child]->time, &timer->time, <)) {
+			break;
+		}
+		openr2_timer_shard_heap_set(shard, i, shard->heap[child]);
+		i = child;
+	}
+	openr2_timer_shard_heap_set(shard, i, timer);
+}
+
+#ifdef HAVE_SYS_TIMERFD_H
+static void openr2_context_timer_fd_set(openr2_context_t *r2context, int pending, struct timeval *next)
+{
+	struct itimerspec its;
+	struct timeval now;
+	long long usecs;
+	/* an all zeros value disarms the timer */
+	memset(&its, 0, sizeof(its));
+	if (!pending) {
+		/* nothing to do */
+	} else if (openr2_context_get_time(r2context, &now) || openr2_timer_due(next, &now)) {
+		/* the schedule finds it expired already, fire right away */
+		its.it_value.tv_nsec = 1;
+	} else {
+		/* the timer fd has its own clock, so arm it relative to ours and late enough for a coarse
+		   clock to have reached the deadline by then. Otherwise it would fire while the schedule
+		   still finds nothing expired, and we would arm it in the past again and again */
+		usecs = ((long long)(next->tv_sec - now.tv_sec) * 1000000) + (next->tv_usec - now.tv_usec);
+		its.it_value.tv_sec = usecs / 1000000;
+		its.it_value.tv_nsec = ((usecs % 1000000) * 1000) + r2context->clock_lag_ns;
+		if (its.it_value.tv_nsec >= 1000000000) {
+			its.it_value.tv_sec++;
+			its.it_value.tv_nsec -= 1000000000;
+		}
+		if (!its.it_value.tv_sec && !its.it_value.tv_nsec) {
+			its.it_value.tv_nsec = 1;
+		}
+	}
+	if (timerfd_settime(r2context->timer_fd, 0, &its, NULL)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to arm context timer fd: %s\n", strerror(errno));
+	}
+}
+
+/* arm the timerfd to expire along with the earliest timer of the context shards. Shards
+   publish their earliest deadline before calling this, so whoever arms the timer last checks
+   that nothing changed since it computed the deadline and tries again otherwise */
+static void openr2_context_timer_fd_arm(openr2_context_t *r2context)
+{
+	struct timeval next, armed;
+	int pending, armed_pending;
+	if (-1 == r2context->timer_fd) {
+		return;
+	}
+	pending = openr2_context_get_earliest(r2context->timer_shards, OR2_TIMER_SHARDS, &next);
+	do {
+		openr2_context_timer_fd_set(r2context, pending, &next);
+		armed_pending = pending;
+		armed = next;
+		pending = openr2_context_get_earliest(r2context->timer_shards, OR2_TIMER_SHARDS, &next);
+	} while (pending != armed_pending || (pending && openr2_timercmp(&next, &armed, !=)));
+}
+
+OR2_DECLARE(int) openr2_context_get_timer_fd(openr2_context_t *r2context)
+{
+	int timer_fd;
+	openr2_mutex_lock(r2context->timers_lock);
+	if (-1 == r2context->timer_fd) {
+		timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		if (-1 == timer_fd) {
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to create context timer fd: %s\n", strerror(errno));
+			r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+		}
+		openr2_atomic_barrier();
+		r2context->timer_fd = timer_fd;
+		openr2_context_timer_fd_arm(r2context);
+	}
+	timer_fd = r2context->timer_fd;
+	openr2_mutex_unlock(r2context->timers_lock);
+	return timer_fd;
+}
+#else
+#define openr2_context_timer_fd_arm(r2context)
+
+OR2_DECLARE(int) openr2_context_get_timer_fd(openr2_context_t *r2context)
+{
+	r2context->last_error = OR2_LIBERR_NOT_SUPPORTED;
+	return -1;
+}
+#endif
+
+static int openr2_timer_shard_init(openr2_timer_shard_t *shard, openr2_context_t *r2context, openr2_worker_t *worker)
+{
+	memset(shard, 0, sizeof(*shard));
+	shard->r2context = r2context;
+	shard->worker = worker;
+	if (openr2_mutex_create(&shard->lock) != OR2_SUCCESS) {
+		return -1;
+	}
+	return 0;
+}
+
+static void openr2_timer_shard_destroy(openr2_timer_shard_t *shard)
+{
+	if (shard->lock) {
+		openr2_mutex_destroy(&shard->lock);
+	}
+	free(shard->heap);
+	shard->heap = NULL;
+}
+
+/* publish the new earliest deadline of the shard, must be called with the shard lock held */
+static void openr2_timer_shard_publish(openr2_timer_shard_t *shard)
+{
+	shard->seq++;
+	openr2_atomic_barrier();
+	shard->pending = shard->len ? 1 : 0;
+	if (shard->len) {
+		shard->earliest = shard->heap[0]->time;
+	}
+	openr2_atomic_barrier();
+	shard->seq++;
+	if (!shard->worker) {
+		openr2_context_timer_fd_arm(shard->r2context);
+	} else if (shard->worker->thread_id != openr2_thread_self()) {
+		/* the worker may be sleeping with a later deadline */
+		openr2_context_worker_wakeup(shard->worker);
+	}
+}
+
+/*! \brief must be called with the shard lock held */
+int openr2_timer_shard_add(openr2_timer_shard_t *shard, openr2_sched_timer_t *timer)
+{
+	openr2_sched_timer_t **heap;
+	int size;
+	if (shard->len == shard->size) {
+		size = shard->size ? (shard->size * 2) : OR2_TIMERS_HEAP_MIN_SIZE;
+		heap = realloc(shard->heap, size * sizeof(*heap));
+		if (!heap) {
+			shard->r2context->last_error = OR2_LIBERR_OUT_OF_MEMORY;
+			return -1;
+		}
+		shard->heap = heap;
+		shard->size = size;
+	}
+	openr2_timer_shard_heap_set(shard, shard->len, timer);
+	shard->len++;
+	openr2_timer_shard_heap_up(shard, timer->heap_index);
+	/* new earliest timer */
+	if (!timer->heap_index) {
+		openr2_timer_shard_publish(shard);
+	}
+	return 0;
+}
+
+/*! \brief must be called with the shard lock held */
+void openr2_timer_shard_remove(openr2_timer_shard_t *shard, openr2_sched_timer_t *timer)
+{
+	int i = timer->heap_index;
+	openr2_sched_timer_t *last;
+	shard->len--;
+	last = shard->heap[shard->len];
+	if (i != shard->len) {
+		/* fill the hole with the last timer and restore the heap order */
+		openr2_timer_shard_heap_set(shard, i, last);
+		openr2_timer_shard_heap_up(shard, i);
+		openr2_timer_shard_heap_down(shard, last->heap_index);
+	}
+	timer->heap_index = -1;
+	/* the earliest timer is gone */
+	if (!i) {
+		openr2_timer_shard_publish(shard);
+	}
+}
+
+/* context shard for the timers of a channel not served by a worker */
+#define openr2_context_chan_timer_shard(r2context, r2chan) \
+	(&(r2context)->timer_shards[(unsigned)(r2chan)->number % OR2_TIMER_SHARDS])
+
+/* move the scheduled timers of the channel to another shard, called with the channel lock held */
+static void openr2_context_move_timers(openr2_chan_t *r2chan, openr2_timer_shard_t *shard)
+{
+	openr2_timer_shard_t *old = r2chan->timer_shard;
+	int i;
+	if (old == shard) {
+		return;
+	}
+	if (old && r2chan->timers_count) {
+		openr2_mutex_lock(old->lock);
+		for (i = 0; i < OR2_MAX_SCHED_TIMERS; i++) {
+			if (r2chan->sched_timers[i].id) {
+				openr2_timer_shard_remove(old, &r2chan->sched_timers[i]);
+			}
+		}
+		openr2_mutex_unlock(old->lock);
+		openr2_mutex_lock(shard->lock);
+		for (i = 0; i < OR2_MAX_SCHED_TIMERS; i++) {
+			if (r2chan->sched_timers[i].id && openr2_timer_shard_add(shard, &r2chan->sched_timers[i])) {
+				openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "Failed to move timer %d (%s), dropping it!\n", 
+						r2chan->sched_timers[i].id, r2chan->sched_timers[i].name);
+				memset(&r2chan->sched_timers[i], 0, sizeof(r2chan->sched_timers[0]));
+				r2chan->timers_count--;
+			}
+		}
+		openr2_mutex_unlock(shard->lock);
+	}
+	r2chan->timer_shard = shard;
+}
+
+/* milliseconds until the earliest deadline of a set of shards, 0 if already expired and -1 if none */
+static int openr2_context_get_time_to_deadline(openr2_context_t *r2context, openr2_timer_shard_t *shards, int count)
+{
+	struct timeval currtime, next;
+
+	if (!openr2_context_get_earliest(shards, count, &next)) {
+		return -1;
+	}
+
+	if (-1 == openr2_context_get_time(r2context, &currtime)) {
 		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to get next context event time: %s\n", strerror(errno));
+		return -1;
+	}
+
+	/* if the time has passed already, return 0 to attend immediately */
+	return openr2_timer_wait_ms(&next, &currtime);
+}
+
+OR2_DECLARE(int) openr2_context_get_time_to_next_event(openr2_context_t *r2context)
+{
+	return openr2_context_get_time_to_deadline(r2context, r2context->timer_shards, OR2_TIMER_SHARDS);
+}
+
+/* max number of channels served on each run of the context schedule */
+#define OR2_MAX_SCHED_CHANNELS 64
+
+/* collect the channels owning the expired timers of the heap subtree at i, must be called with the shard lock held */
+static int openr2_context_collect_expired(openr2_timer_shard_t *shard, int i, const struct timeval *now, openr2_chan_t **expired, int count)
+{
+	openr2_sched_timer_t *timer;
+	int c;
+	if (i >= shard->len || count == OR2_MAX_SCHED_CHANNELS) {
+		return count;
+	}
+	timer = shard->heap[i];
+	/* no timer below this one can be expired */
+	if (!openr2_timer_due(&timer->time, now)) {
+		return count;
+	}
+	for (c = 0; c < count && expired[c] != timer->r2chan; c++);
+	if (c == count) {
+		expired[count++] = timer->r2chan;
+	}
+	count = openr2_context_collect_expired(shard, OR2_TIMERS_HEAP_LEFT(i), now, expired, count);
+	return openr2_context_collect_expired(shard, OR2_TIMERS_HEAP_LEFT(i) + 1, now, expired, count);
+}
+
+static void openr2_context_reactor_watch(openr2_context_t *r2context, openr2_chan_t *r2chan);
+
+/* run the schedule of the channels with expired timers in a set of shards at the given time, leaving
+   the channels served in expired. Must be called with the serving lock of the shards held so the
+   channels collected stay alive once the shard lock is released */
+static int openr2_context_run_shards_schedule(openr2_context_t *r2context, openr2_timer_shard_t *shards, int nshards, 
+		const struct timeval *now, openr2_chan_t *expired[OR2_MAX_SCHED_CHANNELS])
+{
+	struct timeval next;
+	int count = 0;
+	int c, s;
+
+	for (s = 0; s < nshards && count < OR2_MAX_SCHED_CHANNELS; s++) {
+		/* skip the shards with nothing expired without taking their lock */
+		if (!openr2_timer_shard_get_earliest(&shards[s], &next) || !openr2_timer_due(&next, now)) {
+			continue;
+		}
+		openr2_mutex_lock(shards[s].lock);
+		count = openr2_context_collect_expired(&shards[s], 0, now, expired, count);
+		openr2_mutex_unlock(shards[s].lock);
+	}
+
+	/* channel timers are dispatched with the channel lock held and without the shard lock */
+	for (c = 0; c < count; c++) {
+		openr2_chan_run_timers(expired[c], now);
+		openr2_context_reactor_watch(r2context, expired[c]);
+	}
+
+	/* the timer fd may have fired for a deadline the clock snapshot did not consider due yet,
+	   arm it again even if the earliest timer did not change so it does not stay readable */
+	if (!shards[0].worker) {
+		openr2_context_timer_fd_arm(r2context);
+	}
+	return count;
+}
+
+/* Run the schedule of every channel with expired timers, except the ones served
+   by the context workers. Returns the number of channels served */
+OR2_DECLARE(int) openr2_context_run_schedule(openr2_context_t *r2context)
+{
+	openr2_chan_t *expired[OR2_MAX_SCHED_CHANNELS];
+	struct timeval now;
+	int served;
+	if (openr2_context_get_time(r2context, &now)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to get time to run the context schedule: %s\n", strerror(errno));
+		return -1;
+	}
+	openr2_mutex_lock(r2context->reactor_lock);
+	served = openr2_context_run_shards_schedule(r2context, r2context->timer_shards, OR2_TIMER_SHARDS, &now, expired);
+	openr2_mutex_unlock(r2context->reactor_lock);
+	return served;
+}
+
+/* process channels with known ready I/O events and the expired timers of a set of shards,
+   all with a single clock snapshot. Must be called with the serving lock of the shards held.
+   Returns the number of channels served or -1 on error */
+static int openr2_context_process_shards_ready(openr2_context_t *r2context, openr2_timer_shard_t *shards, int nshards,
+		openr2_chan_t **chans, int *events, int n)
+{
+	openr2_chan_t *expired[OR2_MAX_SCHED_CHANNELS];
+	struct timeval now;
+	int count, served, i, c;
+
+	if (openr2_context_get_time(r2context, &now)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to get time to process the ready channels: %s\n", strerror(errno));
+		r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+		return -1;
+	}
+
+	/* timers first, as openr2_chan_process_signaling() does */
+	count = openr2_context_run_shards_schedule(r2context, shards, nshards, &now, expired);
+
+	served = count;
+	for (i = 0; i < n; i++) {
+		openr2_chan_process_ready(chans[i], events[i], &now);
+		openr2_context_reactor_watch(r2context, chans[i]);
+		/* a channel that also had its timers run is only counted once */
+		for (c = 0; c < count && expired[c] != chans[i]; c++);
+		if (c == count) {
+			served++;
+		}
+	}
+	return served;
+}
+
+/* Process the n channels in chans knowing they are ready for the OR2_IO_* events in events[i],
+   without polling their devices, and run the schedule of the channels not served by the context
+   workers. Returns the number of channels served or -1 on error */
+OR2_DECLARE(int) openr2_context_process_ready(openr2_context_t *r2context, openr2_chan_t **chans, int *events, int n)
+{
+	int served;
+	openr2_mutex_lock(r2context->reactor_lock);
+	served = openr2_context_process_shards_ready(r2context, r2context->timer_shards, OR2_TIMER_SHARDS, chans, events, n);
+	openr2_mutex_unlock(r2context->reactor_lock);
+	return served;
+}
+
+/* list of the channels served by the given worker, or by the context reactor if NULL */
+#define openr2_context_serving_list(r2context, worker) \
+	((worker) ? &(worker)->chanlist : &(r2context)->chanlist)
+
+/* put the channel at the head of the list of the thread serving it */
+static void openr2_context_link_channel(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	openr2_chan_t **list = openr2_context_serving_list(r2context, r2chan->worker);
+	r2chan->next = *list;
+	*list = r2chan;
+}
+
+/* take the channel out of the list of the thread serving it */
+static void openr2_context_unlink_channel(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	openr2_chan_t **curr = openr2_context_serving_list(r2context, r2chan->worker);
+	for ( ; *curr; curr = &(*curr)->next) {
+		if (*curr != r2chan) {
+			continue;
+		}
+		*curr = r2chan->next;
+		r2chan->next = NULL;
+		/* ready events the serving thread is waiting for may be about this channel */
+		if (r2chan->worker) {
+			r2chan->worker->removals++;
+		} else {
+			r2context->reactor_removals++;
+		}
+		return;
+	}
+}
 
-		openr2_mutex_unlock(r2context->timers_lock);
+/* worker that should serve the channel, NULL for the context reactor. 
+   Must be called with the context reactor lock held */
+static openr2_worker_t *openr2_context_pick_worker(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	if (!r2context->num_workers) {
+		return NULL;
+	}
+	return &r2context->workers[(unsigned)r2chan->span_id % r2context->num_workers];
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+/* max number of ready channels handled on each reactor iteration */
+#define OR2_REACTOR_MAX_EVENTS 64
+
+/* epoll set watching the channel, the one of its worker or the context reactor */
+#define openr2_context_chan_reactor_fd(r2context, r2chan) \
+	((r2chan)->worker ? (r2chan)->worker->reactor_fd : (r2context)->reactor_fd)
+
+/* start watching the channel fd or update the events we watch for if needed */
+static void openr2_context_reactor_watch(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	struct epoll_event ev;
+	int events, wanted, op;
+	int reactor_fd = openr2_context_chan_reactor_fd(r2context, r2chan);
+	if (-1 == reactor_fd) {
+		return;
+	}
+	/* OOB events (CAS changes, alarms etc) are always interesting, media only when reading or writing tones */
+	events = EPOLLPRI;
+	wanted = openr2_chan_get_wanted_events(r2chan);
+	if (wanted & OR2_IO_READ) {
+		events |= EPOLLIN;
+	}
+	if (wanted & OR2_IO_WRITE) {
+		events |= EPOLLOUT;
+	}
+	if (events == r2chan->reactor_events) {
+		return;
+	}
+	memset(&ev, 0, sizeof(ev));
+	ev.events = events;
+	ev.data.ptr = r2chan;
+	op = r2chan->reactor_events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	if (epoll_ctl(reactor_fd, op, (int)(long)r2chan->fd, &ev)) {
+		openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_WARNING, "Failed to watch channel in the context reactor: %s\n", strerror(errno));
+		return;
+	}
+	r2chan->reactor_events = events;
+}
+
+static void openr2_context_reactor_unwatch(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	struct epoll_event ev;
+	int reactor_fd = openr2_context_chan_reactor_fd(r2context, r2chan);
+	if (-1 == reactor_fd || !r2chan->reactor_events) {
+		return;
+	}
+	/* older kernels require a non-NULL event even for EPOLL_CTL_DEL */
+	memset(&ev, 0, sizeof(ev));
+	epoll_ctl(reactor_fd, EPOLL_CTL_DEL, (int)(long)r2chan->fd, &ev);
+	r2chan->reactor_events = 0;
+}
+
+static void openr2_context_reactor_close(int *reactor_fd, int wakefd[2])
+{
+	if (-1 == *reactor_fd) {
+		return;
+	}
+	if (wakefd[0] != -1) {
+		close(wakefd[0]);
+		close(wakefd[1]);
+		wakefd[0] = -1;
+		wakefd[1] = -1;
+	}
+	close(*reactor_fd);
+	*reactor_fd = -1;
+}
+
+/* create an epoll set watching the read end of a new wake up pipe */
+static int openr2_context_reactor_create(openr2_context_t *r2context, int *reactor_fd, int wakefd[2])
+{
+	struct epoll_event ev;
+	*reactor_fd = epoll_create(OR2_REACTOR_MAX_EVENTS);
+	if (-1 == *reactor_fd) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to create context reactor: %s\n", strerror(errno));
+		r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
 		return -1;
 	}
+	if (pipe(wakefd)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to create context reactor wake up pipe: %s\n", strerror(errno));
+		goto failed;
+	}
+	fcntl(wakefd[0], F_SETFL, O_NONBLOCK);
+	fcntl(wakefd[1], F_SETFL, O_NONBLOCK);
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	/* NULL data means wake up request, any other value is a channel */
+	ev.data.ptr = NULL;
+	if (epoll_ctl(*reactor_fd, EPOLL_CTL_ADD, wakefd[0], &ev)) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to watch context reactor wake up pipe: %s\n", strerror(errno));
+		goto failed;
+	}
+	return 0;
+
+failed:
+	r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+	openr2_context_reactor_close(reactor_fd, wakefd);
+	return -1;
+}
+
+static void openr2_context_reactor_wakeup(openr2_context_t *r2context, int wakefd)
+{
+	if (wakefd != -1) {
+		if (write(wakefd, "w", 1) == -1 && errno != EAGAIN) {
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to wake up context reactor: %s\n", strerror(errno));
+		}
+	}
+}
 
-	while (current) {
-		/* ignore any entry with no sched timer */
-		if (current->timers_count < 1) {
-			current = current->next;
+static int openr2_context_reactor_init(openr2_context_t *r2context)
+{
+	struct epoll_event ev;
+	openr2_chan_t *current;
+	if (r2context->reactor_fd != -1) {
+		return 0;
+	}
+	if (openr2_context_reactor_create(r2context, &r2context->reactor_fd, r2context->reactor_wakefd)) {
+		return -1;
+	}
+#ifdef HAVE_SYS_TIMERFD_H
+	/* let the timer fd wake us up when the next timer is due, the context
+	   pointer as data means timer expiration */
+	if (openr2_context_get_timer_fd(r2context) != -1) {
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = r2context;
+		if (epoll_ctl(r2context->reactor_fd, EPOLL_CTL_ADD, r2context->timer_fd, &ev)) {
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to watch context timer fd: %s\n", strerror(errno));
+			r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+			openr2_context_reactor_close(&r2context->reactor_fd, r2context->reactor_wakefd);
+			return -1;
+		}
+	}
+#endif
+	/* channels served by a worker are already watched by it */
+	openr2_mutex_lock(r2context->reactor_lock);
+	for (current = r2context->chanlist; current; current = current->next) {
+		openr2_context_reactor_watch(r2context, current);
+		/* commands posted before we had a way to be woken up */
+		if (current->command_queue) {
+			openr2_context_wakeup(r2context, NULL);
+		}
+	}
+	openr2_mutex_unlock(r2context->reactor_lock);
+	return 0;
+}
+
+static void openr2_context_reactor_destroy(openr2_context_t *r2context)
+{
+	openr2_context_reactor_close(&r2context->reactor_fd, r2context->reactor_wakefd);
+}
+
+/* whether the channel is in the given list */
+static int openr2_context_chanlist_has(openr2_chan_t *chanlist, openr2_chan_t *r2chan)
+{
+	for ( ; chanlist; chanlist = chanlist->next) {
+		if (chanlist == r2chan) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Wait for I/O on the channels served by the given worker (NULL for the context reactor) for up to
+   ms milliseconds and process the ready channels and the expired timers. Returns the number of
+   channels served or -1 on error */
+static int openr2_context_reactor_poll(openr2_context_t *r2context, openr2_worker_t *worker, int ms)
+{
+	struct epoll_event events[OR2_REACTOR_MAX_EVENTS];
+	openr2_chan_t *ready[OR2_REACTOR_MAX_EVENTS];
+	int ready_events[OR2_REACTOR_MAX_EVENTS];
+	char wakebuf[32];
+	openr2_chan_t *r2chan;
+	openr2_mutex_t *lock = worker ? worker->lock : r2context->reactor_lock;
+	openr2_chan_t **chanlist = openr2_context_serving_list(r2context, worker);
+	volatile unsigned int *removals = worker ? &worker->removals : &r2context->reactor_removals;
+	unsigned int seen_removals;
+	int res, i, n, served, woken;
+	int reactor_fd = worker ? worker->reactor_fd : r2context->reactor_fd;
+	int wakefd = worker ? worker->reactor_wakefd[0] : r2context->reactor_wakefd[0];
+
+	/* channels leave the epoll set before bumping the removals count, if it does not change
+	   while we wait all the channels we get from epoll are still served by us */
+	seen_removals = *removals;
+	openr2_atomic_barrier();
+	res = epoll_wait(reactor_fd, events, OR2_REACTOR_MAX_EVENTS, ms);
+	if (-1 == res) {
+		if (EINTR == errno) {
+			return 0;
+		}
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to wait for context events: %s\n", strerror(errno));
+		r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+		return -1;
+	}
+
+	/* channels cannot leave us (and be deleted) while we serve them */
+	openr2_mutex_lock(lock);
+
+	n = 0;
+	woken = 0;
+	for (i = 0; i < res; i++) {
+		r2chan = events[i].data.ptr;
+		if (!r2chan) {
+			/* someone just wanted to wake us up, may be to run posted commands */
+			while (read(wakefd, wakebuf, sizeof(wakebuf)) > 0);
+			woken = 1;
+			continue;
+		}
+		if ((void *)r2chan == (void *)r2context) {
+			/* a timer is due, the schedule is run below and will re-arm the timer fd */
+			while (read(r2context->timer_fd, wakebuf, sizeof(wakebuf)) > 0);
 			continue;
 		}
-		/* if no winner, set this as winner */
-		if (!winner) {
-			winner = current;
+		if (seen_removals != *removals && !openr2_context_chanlist_has(*chanlist, r2chan)) {
+			/* the channel left us while we were waiting */
+			continue;
+		}
+		/* we already know what the channel is ready for, no need to poll it again */
+		ready[n] = r2chan;
+		ready_events[n] = 0;
+		if (events[i].events & EPOLLIN) {
+			ready_events[n] |= OR2_IO_READ;
+		}
+		if (events[i].events & EPOLLOUT) {
+			ready_events[n] |= OR2_IO_WRITE;
 		}
-		current = current->next;
-		/* if no more chans, return the winner */
-		if (!current) {
-			ms = (((winner->sched_timers[0].time.tv_sec - currtime.tv_sec) * 1000) + 
-			     ((winner->sched_timers[0].time.tv_usec - currtime.tv_usec) / 1000));
+		if (events[i].events & (EPOLLPRI | EPOLLERR | EPOLLHUP)) {
+			ready_events[n] |= OR2_IO_OOB_EVENT;
+		}
+		n++;
+	}
 
-			openr2_mutex_unlock(r2context->timers_lock);
+	/* timers are due regardless of the channel fd being ready */
+	if (worker) {
+		served = openr2_context_process_shards_ready(r2context, &worker->timers, 1, ready, ready_events, n);
+	} else {
+		served = openr2_context_process_shards_ready(r2context, r2context->timer_shards, OR2_TIMER_SHARDS, ready, ready_events, n);
+	}
 
-			/* if the time has passed already, return 0 to attend immediately */
-			if (ms < 0) {
-				return 0;
-			}	
-			return ms;
+	/* channels with posted commands may not have any I/O pending */
+	if (woken && served >= 0) {
+		for (r2chan = *chanlist; r2chan; r2chan = r2chan->next) {
+			if (!r2chan->command_queue) {
+				continue;
+			}
+			openr2_chan_process_ready(r2chan, 0, NULL);
+			openr2_context_reactor_watch(r2context, r2chan);
+			served++;
 		}
-		/* if the winner timer is after the current timer, then we have a new winner */
-		if (openr2_timercmp(&winner->sched_timers[0].time, &current->sched_timers[0].time, >) ) {
-			winner = current;
+	}
+
+	openr2_mutex_unlock(lock);
+	return served;
+}
+
+/* Wait for I/O on any of the context channels for up to timeout ms (-1 to wait until the next
+   scheduled timer) and process the ready channels and the expired timers. Returns the number of
+   channels served or -1 on error */
+OR2_DECLARE(int) openr2_context_poll_once(openr2_context_t *r2context, int timeout)
+{
+	int ms;
+
+	if (openr2_context_reactor_init(r2context)) {
+		return -1;
+	}
+
+	if (r2context->timer_fd != -1) {
+		/* the timer fd takes care of waking us up for the next timer */
+		ms = timeout;
+	} else {
+		ms = openr2_context_get_time_to_next_event(r2context);
+		if (timeout >= 0 && (ms < 0 || timeout < ms)) {
+			ms = timeout;
 		}
 	}
 
-	openr2_mutex_unlock(r2context->timers_lock);
+	return openr2_context_reactor_poll(r2context, NULL, ms);
+}
+
+OR2_DECLARE(int) openr2_context_run(openr2_context_t *r2context)
+{
+	if (openr2_context_reactor_init(r2context)) {
+		return -1;
+	}
+	while (!r2context->reactor_stop) {
+		if (-1 == openr2_context_poll_once(r2context, -1)) {
+			return -1;
+		}
+	}
+	r2context->reactor_stop = 0;
+	return 0;
+}
+
+void openr2_context_worker_wakeup(openr2_worker_t *worker)
+{
+	openr2_context_reactor_wakeup(worker->r2context, worker->reactor_wakefd[1]);
+}
+
+/* wake up the thread serving the given channel, or the context reactor if r2chan is NULL */
+void openr2_context_wakeup(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	if (r2chan && r2chan->worker) {
+		openr2_context_worker_wakeup(r2chan->worker);
+	} else {
+		openr2_context_reactor_wakeup(r2context, r2context->reactor_wakefd[1]);
+	}
+}
+
+OR2_DECLARE(void) openr2_context_stop(openr2_context_t *r2context)
+{
+	r2context->reactor_stop = 1;
+	openr2_context_wakeup(r2context, NULL);
+}
+
+static void *openr2_context_worker_run(openr2_thread_t *thread, void *data)
+{
+	openr2_worker_t *worker = data;
+	openr2_context_t *r2context = worker->r2context;
+	int ms;
+
+	worker->thread_id = openr2_thread_self();
+	if (worker->cpu >= 0 && openr2_thread_set_cpu_affinity(worker->cpu) != OR2_SUCCESS) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_WARNING, "Failed to pin context worker %d to CPU %d\n", worker->id, worker->cpu);
+	}
+	openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_DEBUG, "Context worker %d started\n", worker->id);
+	while (!worker->stop) {
+		ms = openr2_context_get_time_to_deadline(r2context, &worker->timers, 1);
+		if (-1 == openr2_context_reactor_poll(r2context, worker, ms)) {
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Context worker %d failed, no longer serving its channels\n", worker->id);
+			break;
+		}
+	}
+	openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_DEBUG, "Context worker %d done\n", worker->id);
+	return NULL;
+}
+
+/* Start num_workers threads to serve the context channels, each channel is served by worker
+   span_id % num_workers. Worker i is pinned to cpus[i] (no pinning if negative) or to CPU i
+   modulo the number of online CPUs if cpus is NULL */
+OR2_DECLARE(int) openr2_context_start_workers(openr2_context_t *r2context, int num_workers, const int *cpus)
+{
+	openr2_worker_t *worker;
+	openr2_chan_t *r2chan, *next;
+	long ncpus;
+	int i;
+
+	if (num_workers <= 0) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Invalid number of context workers %d\n", num_workers);
+		return -1;
+	}
+	openr2_mutex_lock(r2context->reactor_lock);
+	if (r2context->workers) {
+		openr2_mutex_unlock(r2context->reactor_lock);
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Context workers already started\n");
+		return -1;
+	}
+	r2context->workers = openr2_calloc(num_workers, sizeof(*r2context->workers));
+	if (!r2context->workers) {
+		openr2_mutex_unlock(r2context->reactor_lock);
+		r2context->last_error = OR2_LIBERR_OUT_OF_MEMORY;
+		return -1;
+	}
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	for (i = 0; i < num_workers; i++) {
+		worker = &r2context->workers[i];
+		worker->r2context = r2context;
+		worker->id = i;
+		worker->cpu = cpus ? cpus[i] : (ncpus > 0 ? (int)(i % ncpus) : -1);
+		worker->reactor_wakefd[0] = -1;
+		worker->reactor_wakefd[1] = -1;
+		if (openr2_mutex_create(&worker->lock) != OR2_SUCCESS) {
+			r2context->last_error = OR2_LIBERR_OUT_OF_MEMORY;
+			goto failed;
+		}
+		if (openr2_timer_shard_init(&worker->timers, r2context, worker)) {
+			r2context->last_error = OR2_LIBERR_OUT_OF_MEMORY;
+			openr2_mutex_destroy(&worker->lock);
+			goto failed;
+		}
+		if (openr2_context_reactor_create(r2context, &worker->reactor_fd, worker->reactor_wakefd)) {
+			openr2_timer_shard_destroy(&worker->timers);
+			openr2_mutex_destroy(&worker->lock);
+			goto failed;
+		}
+	}
+	r2context->num_workers = num_workers;
+
+	/* move the channels to their workers before the threads start serving them */
+	for (r2chan = r2context->chanlist; r2chan; r2chan = next) {
+		next = r2chan->next;
+		openr2_context_assign_worker(r2context, r2chan);
+	}
+	openr2_mutex_unlock(r2context->reactor_lock);
+
+	for (i = 0; i < num_workers; i++) {
+		worker = &r2context->workers[i];
+		if (openr2_thread_create_joinable(&worker->thread, openr2_context_worker_run, worker) != OR2_SUCCESS) {
+			worker->thread = NULL;
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to create context worker %d\n", i);
+			r2context->last_error = OR2_LIBERR_SYSCALL_FAILED;
+			openr2_context_stop_workers(r2context);
+			return -1;
+		}
+	}
+	return 0;
+
+failed:
+	while (i--) {
+		worker = &r2context->workers[i];
+		openr2_context_reactor_close(&worker->reactor_fd, worker->reactor_wakefd);
+		openr2_timer_shard_destroy(&worker->timers);
+		openr2_mutex_destroy(&worker->lock);
+	}
+	openr2_safe_free(r2context->workers);
+	openr2_mutex_unlock(r2context->reactor_lock);
+	return -1;
+}
+
+/* Stop the context workers and wait for them to exit, the channels
+   are served by the context reactor again */
+OR2_DECLARE(int) openr2_context_stop_workers(openr2_context_t *r2context)
+{
+	openr2_worker_t *worker;
+	openr2_chan_t *r2chan;
+	int i;
+
+	if (!r2context->workers) {
+		return 0;
+	}
+	for (i = 0; i < r2context->num_workers; i++) {
+		worker = &r2context->workers[i];
+		worker->stop = 1;
+		openr2_context_worker_wakeup(worker);
+	}
+	for (i = 0; i < r2context->num_workers; i++) {
+		worker = &r2context->workers[i];
+		if (worker->thread && openr2_thread_join(worker->thread) != OR2_SUCCESS) {
+			openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Failed to wait for context worker %d\n", i);
+		}
+		worker->thread = NULL;
+	}
+
+	/* give the channels back to the context reactor */
+	openr2_mutex_lock(r2context->reactor_lock);
+	i = r2context->num_workers;
+	r2context->num_workers = 0;
+	while (i--) {
+		worker = &r2context->workers[i];
+		while ((r2chan = worker->chanlist)) {
+			openr2_context_assign_worker(r2context, r2chan);
+		}
+		openr2_context_reactor_close(&worker->reactor_fd, worker->reactor_wakefd);
+		openr2_timer_shard_destroy(&worker->timers);
+		openr2_mutex_destroy(&worker->lock);
+	}
+	openr2_safe_free(r2context->workers);
+	openr2_mutex_unlock(r2context->reactor_lock);
+	return 0;
+}
+#else
+static void openr2_context_reactor_watch(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+}
+
+#define openr2_context_reactor_unwatch(r2context, r2chan)
+#define openr2_context_reactor_destroy(r2context)
+
+OR2_DECLARE(int) openr2_context_poll_once(openr2_context_t *r2context, int timeout)
+{
+	r2context->last_error = OR2_LIBERR_NOT_SUPPORTED;
 	return -1;
 }
 
+OR2_DECLARE(int) openr2_context_run(openr2_context_t *r2context)
+{
+	r2context->last_error = OR2_LIBERR_NOT_SUPPORTED;
+	return -1;
+}
+
+void openr2_context_wakeup(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+}
+
+void openr2_context_worker_wakeup(openr2_worker_t *worker)
+{
+}
+
+OR2_DECLARE(void) openr2_context_stop(openr2_context_t *r2context)
+{
+	r2context->reactor_stop = 1;
+}
+
+OR2_DECLARE(int) openr2_context_start_workers(openr2_context_t *r2context, int num_workers, const int *cpus)
+{
+	r2context->last_error = OR2_LIBERR_NOT_SUPPORTED;
+	return -1;
+}
+
+OR2_DECLARE(int) openr2_context_stop_workers(openr2_context_t *r2context)
+{
+	return 0;
+}
+#endif
+
+/* move the channel to the list, reactor and timer shard of the given worker (NULL for the context
+   reactor). Must be called with the serving locks involved and the channel lock held */
+static void openr2_context_move_channel(openr2_context_t *r2context, openr2_chan_t *r2chan, openr2_worker_t *worker)
+{
+	openr2_context_reactor_unwatch(r2context, r2chan);
+	openr2_context_unlink_channel(r2context, r2chan);
+	r2chan->worker = worker;
+	openr2_context_link_channel(r2context, r2chan);
+	openr2_context_move_timers(r2chan, worker ? &worker->timers : openr2_context_chan_timer_shard(r2context, r2chan));
+	/* start watching it if its reactor is already running */
+	openr2_context_reactor_watch(r2context, r2chan);
+	if (r2chan->command_queue) {
+		openr2_context_wakeup(r2context, r2chan);
+	}
+}
+
+/* serve the channel from the worker of its span, or from the context reactor if there
+   are no workers. Must not be called with the channel lock held */
+void openr2_context_assign_worker(openr2_context_t *r2context, openr2_chan_t *r2chan)
+{
+	openr2_worker_t *worker, *old;
+	openr2_mutex_lock(r2context->reactor_lock);
+	old = r2chan->worker;
+	worker = openr2_context_pick_worker(r2context, r2chan);
+	if (worker != old) {
+		/* whoever takes more than one worker lock holds the context reactor lock first */
+		if (old) {
+			openr2_mutex_lock(old->lock);
+		}
+		if (worker) {
+			openr2_mutex_lock(worker->lock);
+		}
+		openr2_chan_lock(r2chan);
+		openr2_context_move_channel(r2context, r2chan, worker);
+		openr2_chan_unlock(r2chan);
+		if (worker) {
+			openr2_mutex_unlock(worker->lock);
+		}
+		if (old) {
+			openr2_mutex_unlock(old->lock);
+		}
+	}
+	openr2_mutex_unlock(r2context->reactor_lock);
+}
+
 void openr2_context_add_channel(openr2_context_t *r2context, openr2_chan_t *r2chan)
 {
-	/* put the channel at the head of the list*/
-	openr2_chan_t *head = r2context->chanlist;
-	r2context->chanlist = r2chan;
-	r2chan->next = head;
 	/* set the channel log level to our level. Users can override this */
 	openr2_chan_set_log_level(r2chan, r2context->loglevel);
+	/* start in the context reactor, then hand the channel to the worker of its span if there are workers */
+	openr2_mutex_lock(r2context->reactor_lock);
+	openr2_chan_lock(r2chan);
+	openr2_context_move_channel(r2context, r2chan, NULL);
+	openr2_chan_unlock(r2chan);
+	openr2_context_assign_worker(r2context, r2chan);
+	openr2_mutex_unlock(r2context->reactor_lock);
 }
 
+/* stop serving the channel, once this returns no context thread is using it 
+   anymore. Must not be called with the channel lock held */
 void openr2_context_remove_channel(openr2_context_t *r2context, openr2_chan_t *r2chan)
 {
-	openr2_chan_t *curr = r2context->chanlist;
-	openr2_chan_t *prev = NULL;
-	while (curr) {
-		if(curr == r2chan) {
-			if (prev) {
-				prev->next = curr->next;
-			}	
-			if (curr == r2context->chanlist) {
-				r2context->chanlist = NULL;
-			}	
-			break;
-		}
-		prev = curr;
-		curr = curr->next;
+	openr2_worker_t *worker;
+	openr2_mutex_lock(r2context->reactor_lock);
+	worker = r2chan->worker;
+	if (worker) {
+		openr2_mutex_lock(worker->lock);
+	}
+	openr2_chan_lock(r2chan);
+	openr2_context_reactor_unwatch(r2context, r2chan);
+	openr2_context_unlink_channel(r2context, r2chan);
+	openr2_chan_cancel_all_timers(r2chan);
+	r2chan->worker = NULL;
+	openr2_chan_unlock(r2chan);
+	if (worker) {
+		openr2_mutex_unlock(worker->lock);
 	}
+	openr2_mutex_unlock(r2context->reactor_lock);
 }
 
 OR2_DECLARE(void) openr2_context_delete(openr2_context_t *r2context)
 {
-	openr2_chan_t *current, *next;
-	current = r2context->chanlist;
-	while ( current ) {
-		next = current->next;
-		openr2_chan_delete(current);
-		current = next;
+	int i;
+	openr2_context_stop_workers(r2context);
+	while (r2context->chanlist) {
+		openr2_chan_delete(r2context->chanlist);
+	}
+	openr2_context_reactor_destroy(r2context);
+	if (r2context->timer_fd != -1) {
+		close(r2context->timer_fd);
+	}
+	for (i = 0; i < OR2_TIMER_SHARDS; i++) {
+		openr2_timer_shard_destroy(&r2context->timer_shards[i]);
 	}
 	openr2_mutex_destroy(&r2context->timers_lock);
+	openr2_mutex_destroy(&r2context->reactor_lock);
 	free(r2context);
 }
 
@@ -495,6 +1636,7 @@ OR2_DECLARE(const char *) openr2_context_error_string(openr2_liberr_t error)
 	case OR2_LIBERR_INVALID_CHAN_NUMBER: return "Invalid channel number";
 	case OR2_LIBERR_OUT_OF_MEMORY: return "Out of memory";
 	case OR2_LIBERR_INVALID_INTERFACE: return "Invalid interface";
+	case OR2_LIBERR_NOT_SUPPORTED: return "Operation not supported";
 	default: return "*Unknown*";
 	}
 }
@@ -591,6 +1733,32 @@ OR2_DECLARE(int) openr2_context_get_mf_threshold(openr2_context_t *r2context)
 	return r2context->mf_threshold;
 }
 
+OR2_DECLARE(int) openr2_context_set_mf_block(openr2_context_t *r2context, int block, int hop)
+{
+	if (block <= 0) {
+		block = OR2_MF_RX_BLOCK_SAMPLES;
+	}
+	if (hop <= 0) {
+		hop = block;
+	}
+	if (block < OR2_MF_RX_MIN_BLOCK_SAMPLES || block > OR2_MF_RX_BLOCK_SAMPLES || hop > block) {
+		openr2_log2(r2context, OR2_CONTEXT_LOG, OR2_LOG_ERROR, "Invalid MF detection block of %d samples every %d samples\n", block, hop);
+		return -1;
+	}
+	/* takes effect the next time the channels init their MF detector */
+	r2context->mf_block = block;
+	r2context->mf_hop = hop;
+	return 0;
+}
+
+OR2_DECLARE(int) openr2_context_get_mf_block(openr2_context_t *r2context, int *hop)
+{
+	if (hop) {
+		*hop = r2context->mf_hop;
+	}
+	return r2context->mf_block;
+}
+
 OR2_DECLARE(void) openr2_context_set_dtmf_detection(openr2_context_t *r2context, int enable)
 {
 	if (enable < 0) {
@@ -41,6 +41,17 @@
 #include <fcntl.h>
 #endif
 #include <math.h>
+/* The vector kernels are built for every instruction set the compiler can target,
+   and the best one the CPU supports is picked when the library is loaded */
+#if (defined(__x86_64__)  ||  defined(__i386__))  &&  defined(__GNUC__)
+#define OR2_DSP_X86
+#include <immintrin.h>
+#define OR2_DSP_TARGET_SSE2 __attribute__((target("sse2")))
+#define OR2_DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__aarch64__)  &&  defined(__ARM_NEON)
+#define OR2_DSP_NEON
+#include <arm_neon.h>
+#endif
 #include "openr2/r2declare.h"
 #include "openr2/fast_convert.h"
 #include "openr2/r2utils-pvt.h"
@@ -64,35 +75,357 @@
 #define SAMPLE_RATE 8000
 #define DBM0_MAX_SINE_POWER     (3.14f)
 
+/* Clip a mix of samples to the 16 bit range */
+static __inline__ int16_t saturate(int32_t amp)
+{
+    if (amp > INT16_MAX)
+        return INT16_MAX;
+    if (amp < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t) amp;
+}
+
 /* Direct Digital Synthesis required for tone generation */
-static int32_t dds_phase_ratef(float frequency);
-static float dds_scaling_dbm0f(float level);
-static float dds_modf(uint32_t *phase_acc, int32_t phase_rate, float scale, int32_t phase);
+/* The phase step for a frequency in Hz, as a constant so tone descriptors can be static data */
+#define DDS_PHASE_RATE(frequency) ((int32_t) (((uint64_t) (frequency) << 32)/SAMPLE_RATE))
+static int32_t dds_scaling_dbm0(int level);
+static __inline__ int32_t dds_lookup(uint32_t phase, int32_t scale);
+static __inline__ int32_t dds_mod(uint32_t *phase_acc, int32_t phase_rate, int32_t scale);
 
 /* generic tone generation */
-static void make_tone_gen_descriptor(openr2_tone_gen_descriptor_t *s, int f1, int l1, int f2, int l2, int d1, int d2, int d3, int d4, int repeat);
-static openr2_tone_gen_state_t *tone_gen_init(openr2_tone_gen_state_t *s, openr2_tone_gen_descriptor_t *t);
+static openr2_tone_gen_state_t *tone_gen_init(openr2_tone_gen_state_t *s, const openr2_tone_gen_descriptor_t *t);
 static int tone_gen(openr2_tone_gen_state_t *s, int16_t amp[], int max_samples);
 
 /* Goertzel Algorithm for tone detection */
-static void make_goertzel_descriptor(openr2_goertzel_descriptor_t *t, float freq, int samples);
-static openr2_goertzel_state_t *goertzel_init(openr2_goertzel_state_t *s, openr2_goertzel_descriptor_t *t);
+static openr2_goertzel_state_t *goertzel_init(openr2_goertzel_state_t *s, const openr2_goertzel_descriptor_t *t);
 static void goertzel_reset(openr2_goertzel_state_t *s);
 static float goertzel_result(openr2_goertzel_state_t *s);
 
+/* The hot loops, one set for each instruction set, see dsp_kernels[] */
 typedef struct
 {
-    float       f1;         /* First freq */
-    float       f2;         /* Second freq */
-    int8_t      level1;     /* Level of the first freq (dB) */
-    int8_t      level2;     /* Level of the second freq (dB) */
-    uint8_t     on_time;    /* Tone on time (ms) */
-    uint8_t     off_time;   /* Minimum post tone silence (ms) */
-} mf_digit_tones_t;
+    void (*goertzel_update_mf)(openr2_goertzel_state_t s[6], const int16_t amp[], const uint8_t alaw[], int samples);
+    void (*goertzel_update_dtmf)(openr2_goertzel_state_t row[4], openr2_goertzel_state_t col[4], const openr2_goertzel_value_t famp[], int samples);
+    void (*goertzel_update_mf_dual)(openr2_goertzel_state_t s[12], const int16_t amp[], const uint8_t alaw[], int samples);
+    /* Run the six MF filters of every channel of a bank, stride is a multiple of MF_BANK_LANES */
+    void (*goertzel_update_mf_bank)(const openr2_goertzel_value_t fac[], openr2_goertzel_value_t v2[], openr2_goertzel_value_t v3[], const openr2_goertzel_value_t amp[], int stride, int samples);
+    /* Mix samples of the tones, advancing their phases */
+    void (*dds_mix)(int16_t amp[], int samples, uint32_t phase[4], const openr2_tone_gen_tone_descriptor_t tone[4], int tones);
+    void (*alaw_to_linear)(const uint8_t alaw[], int16_t linear[], int samples);
+    void (*linear_to_alaw)(const int16_t linear[], uint8_t alaw[], int samples);
+} dsp_kernels_t;
 
-static int r2_mf_gen_inited = FALSE;
-static openr2_tone_gen_descriptor_t r2_mf_fwd_digit_tones[15];
-static openr2_tone_gen_descriptor_t r2_mf_back_digit_tones[15];
+static const dsp_kernels_t *volatile dsp;
+
+/* One step of the Goertzel recurrence, v3 = fac*v2 - v1 + x */
+#if defined(OR2_USE_FIXED_POINT)
+#define GOERTZEL_Q                  14
+#define goertzel_step(fac, v1, v2, x) ((openr2_goertzel_value_t) (((int64_t) (fac)*(v2)) >> GOERTZEL_Q) - (v1) + (x))
+#else
+#define goertzel_step(fac, v1, v2, x) ((fac)*(v2) - (v1) + (x))
+#endif
+
+/* The detectors take either linear samples or A-law bytes, the other one being NULL */
+#define detector_sample(amp, alaw, i) ((alaw)  ?  openr2_alaw_to_linear_table[(alaw)[i]]  :  (amp)[i])
+
+/* openr2_linear_to_alaw() for every 16 bit sample, indexed by the sample as unsigned
+   shifted down 4 bits, the low 4 bits never make it into the A-law byte */
+static const uint8_t linear_to_alaw_table[4096] =
+{
+    0xd5, 0xd4, 0xd7, 0xd6, 0xd1, 0xd0, 0xd3, 0xd2, 0xdd, 0xdc, 0xdf, 0xde, 0xd9, 0xd8, 0xdb, 0xda,
+    0xc5, 0xc4, 0xc7, 0xc6, 0xc1, 0xc0, 0xc3, 0xc2, 0xcd, 0xcc, 0xcf, 0xce, 0xc9, 0xc8, 0xcb, 0xca,
+    0xf5, 0xf5, 0xf4, 0xf4, 0xf7, 0xf7, 0xf6, 0xf6, 0xf1, 0xf1, 0xf0, 0xf0, 0xf3, 0xf3, 0xf2, 0xf2,
+    0xfd, 0xfd, 0xfc, 0xfc, 0xff, 0xff, 0xfe, 0xfe, 0xf9, 0xf9, 0xf8, 0xf8, 0xfb, 0xfb, 0xfa, 0xfa,
+    0xe5, 0xe5, 0xe5, 0xe5, 0xe4, 0xe4, 0xe4, 0xe4, 0xe7, 0xe7, 0xe7, 0xe7, 0xe6, 0xe6, 0xe6, 0xe6,
+    0xe1, 0xe1, 0xe1, 0xe1, 0xe0, 0xe0, 0xe0, 0xe0, 0xe3, 0xe3, 0xe3, 0xe3, 0xe2, 0xe2, 0xe2, 0xe2,
+    0xed, 0xed, 0xed, 0xed, 0xec, 0xec, 0xec, 0xec, 0xef, 0xef, 0xef, 0xef, 0xee, 0xee, 0xee, 0xee,
+    0xe9, 0xe9, 0xe9, 0xe9, 0xe8, 0xe8, 0xe8, 0xe8, 0xeb, 0xeb, 0xeb, 0xeb, 0xea, 0xea, 0xea, 0xea,
+    0x95, 0x95, 0x95, 0x95, 0x95, 0x95, 0x95, 0x95, 0x94, 0x94, 0x94, 0x94, 0x94, 0x94, 0x94, 0x94,
+    0x97, 0x97, 0x97, 0x97, 0x97, 0x97, 0x97, 0x97, 0x96, 0x96, 0x96, 0x96, 0x96, 0x96, 0x96, 0x96,
+    0x91, 0x91, 0x91, 0x91, 0x91, 0x91, 0x91, 0x91, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90,
+    0x93, 0x93, 0x93, 0x93, 0x93, 0x93, 0x93, 0x93, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92,
+    0x9d, 0x9d, 0x9d, 0x9d, 0x9d, 0x9d, 0x9d, 0x9d, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c,
+    0x9f, 0x9f, 0x9f, 0x9f, 0x9f, 0x9f, 0x9f, 0x9f, 0x9e, 0x9e, 0x9e, 0x9e, 0x9e, 0x9e, 0x9e, 0x9e,
+    0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98,
+    0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0x9a, 0x9a, 0x9a, 0x9a, 0x9a, 0x9a, 0x9a, 0x9a,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85,
+    0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84,
+    0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87, 0x87,
+    0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86, 0x86,
+    0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83,
+    0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82,
+    0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d,
+    0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c,
+    0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f, 0x8f,
+    0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e, 0x8e,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+    0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b,
+    0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a, 0x8a,
+    0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5,
+    0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5, 0xb5,
+    0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4,
+    0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4, 0xb4,
+    0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7,
+    0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7, 0xb7,
+    0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6,
+    0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6, 0xb6,
+    0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1,
+    0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1, 0xb1,
+    0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0,
+    0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0, 0xb0,
+    0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3,
+    0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3, 0xb3,
+    0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2,
+    0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2, 0xb2,
+    0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd,
+    0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd, 0xbd,
+    0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc,
+    0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc, 0xbc,
+    0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf,
+    0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf,
+    0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe,
+    0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe, 0xbe,
+    0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9,
+    0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9, 0xb9,
+    0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8,
+    0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8,
+    0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb,
+    0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb,
+    0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba,
+    0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba, 0xba,
+    0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+    0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+    0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+    0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+    0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4,
+    0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4,
+    0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4,
+    0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4, 0xa4,
+    0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7,
+    0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7,
+    0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7,
+    0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7, 0xa7,
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6,
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6,
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6,
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6,
+    0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1,
+    0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1,
+    0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1,
+    0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1, 0xa1,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0,
+    0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0,
+    0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3,
+    0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3,
+    0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3,
+    0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3, 0xa3,
+    0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2,
+    0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2,
+    0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2,
+    0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2, 0xa2,
+    0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad,
+    0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad,
+    0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad,
+    0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad, 0xad,
+    0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac,
+    0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac,
+    0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac,
+    0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac, 0xac,
+    0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf,
+    0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf,
+    0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf,
+    0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf, 0xaf,
+    0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+    0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+    0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+    0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+    0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9,
+    0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9,
+    0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9,
+    0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9, 0xa9,
+    0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8, 0xa8,
+    0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab,
+    0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab,
+    0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab,
+    0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab, 0xab,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a,
+    0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a,
+    0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a,
+    0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a,
+    0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b,
+    0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b,
+    0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b,
+    0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b, 0x2b,
+    0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29,
+    0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29,
+    0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29,
+    0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29,
+    0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e,
+    0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e,
+    0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e,
+    0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e, 0x2e,
+    0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f,
+    0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f,
+    0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f,
+    0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f,
+    0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c,
+    0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c,
+    0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c,
+    0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c,
+    0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d,
+    0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d,
+    0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d,
+    0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21,
+    0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21,
+    0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21,
+    0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21,
+    0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+    0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+    0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+    0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+    0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+    0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+    0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+    0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27,
+    0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24,
+    0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24,
+    0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24,
+    0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24,
+    0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25,
+    0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25,
+    0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25,
+    0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25,
+    0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a,
+    0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a, 0x3a,
+    0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b,
+    0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b,
+    0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38,
+    0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38,
+    0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39,
+    0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39, 0x39,
+    0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e,
+    0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e, 0x3e,
+    0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f,
+    0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f,
+    0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
+    0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
+    0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+    0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+    0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
+    0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36, 0x36,
+    0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37,
+    0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37, 0x37,
+    0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34,
+    0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34, 0x34,
+    0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35,
+    0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35, 0x35,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09,
+    0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e,
+    0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
+    0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c,
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+    0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1b, 0x1b, 0x1b, 0x1b, 0x1b, 0x1b, 0x1b, 0x1b,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19,
+    0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f,
+    0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1d, 0x1d, 0x1d, 0x1d, 0x1d, 0x1d, 0x1d, 0x1d,
+    0x12, 0x12, 0x12, 0x12, 0x12, 0x12, 0x12, 0x12, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x16, 0x16, 0x16, 0x16, 0x16, 0x16, 0x16, 0x16, 0x17, 0x17, 0x17, 0x17, 0x17, 0x17, 0x17, 0x17,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15,
+    0x6a, 0x6a, 0x6a, 0x6a, 0x6b, 0x6b, 0x6b, 0x6b, 0x68, 0x68, 0x68, 0x68, 0x69, 0x69, 0x69, 0x69,
+    0x6e, 0x6e, 0x6e, 0x6e, 0x6f, 0x6f, 0x6f, 0x6f, 0x6c, 0x6c, 0x6c, 0x6c, 0x6d, 0x6d, 0x6d, 0x6d,
+    0x62, 0x62, 0x62, 0x62, 0x63, 0x63, 0x63, 0x63, 0x60, 0x60, 0x60, 0x60, 0x61, 0x61, 0x61, 0x61,
+    0x66, 0x66, 0x66, 0x66, 0x67, 0x67, 0x67, 0x67, 0x64, 0x64, 0x64, 0x64, 0x65, 0x65, 0x65, 0x65,
+    0x7a, 0x7a, 0x7b, 0x7b, 0x78, 0x78, 0x79, 0x79, 0x7e, 0x7e, 0x7f, 0x7f, 0x7c, 0x7c, 0x7d, 0x7d,
+    0x72, 0x72, 0x73, 0x73, 0x70, 0x70, 0x71, 0x71, 0x76, 0x76, 0x77, 0x77, 0x74, 0x74, 0x75, 0x75,
+    0x4a, 0x4b, 0x48, 0x49, 0x4e, 0x4f, 0x4c, 0x4d, 0x42, 0x43, 0x40, 0x41, 0x46, 0x47, 0x44, 0x45,
+    0x5a, 0x5b, 0x58, 0x59, 0x5e, 0x5f, 0x5c, 0x5d, 0x52, 0x53, 0x50, 0x51, 0x56, 0x57, 0x54, 0x55
+};
+
+/* openr2_alaw_to_linear() for every A-law byte */
+const int16_t openr2_alaw_to_linear_table[256] =
+{
+     -5504,  -5248,  -6016,  -5760,  -4480,  -4224,  -4992,  -4736,
+     -7552,  -7296,  -8064,  -7808,  -6528,  -6272,  -7040,  -6784,
+     -2752,  -2624,  -3008,  -2880,  -2240,  -2112,  -2496,  -2368,
+     -3776,  -3648,  -4032,  -3904,  -3264,  -3136,  -3520,  -3392,
+    -22016, -20992, -24064, -23040, -17920, -16896, -19968, -18944,
+    -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136,
+    -11008, -10496, -12032, -11520,  -8960,  -8448,  -9984,  -9472,
+    -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568,
+      -344,   -328,   -376,   -360,   -280,   -264,   -312,   -296,
+      -472,   -456,   -504,   -488,   -408,   -392,   -440,   -424,
+       -88,    -72,   -120,   -104,    -24,     -8,    -56,    -40,
+      -216,   -200,   -248,   -232,   -152,   -136,   -184,   -168,
+     -1376,  -1312,  -1504,  -1440,  -1120,  -1056,  -1248,  -1184,
+     -1888,  -1824,  -2016,  -1952,  -1632,  -1568,  -1760,  -1696,
+      -688,   -656,   -752,   -720,   -560,   -528,   -624,   -592,
+      -944,   -912,  -1008,   -976,   -816,   -784,   -880,   -848,
+      5504,   5248,   6016,   5760,   4480,   4224,   4992,   4736,
+      7552,   7296,   8064,   7808,   6528,   6272,   7040,   6784,
+      2752,   2624,   3008,   2880,   2240,   2112,   2496,   2368,
+      3776,   3648,   4032,   3904,   3264,   3136,   3520,   3392,
+     22016,  20992,  24064,  23040,  17920,  16896,  19968,  18944,
+     30208,  29184,  32256,  31232,  26112,  25088,  28160,  27136,
+     11008,  10496,  12032,  11520,   8960,   8448,   9984,   9472,
+     15104,  14592,  16128,  15616,  13056,  12544,  14080,  13568,
+       344,    328,    376,    360,    280,    264,    312,    296,
+       472,    456,    504,    488,    408,    392,    440,    424,
+        88,     72,    120,    104,     24,      8,     56,     40,
+       216,    200,    248,    232,    152,    136,    184,    168,
+      1376,   1312,   1504,   1440,   1120,   1056,   1248,   1184,
+      1888,   1824,   2016,   1952,   1632,   1568,   1760,   1696,
+       688,    656,    752,    720,    560,    528,    624,    592,
+       944,    912,   1008,    976,    816,    784,    880,    848
+};
 
 /* R2 tone generation specs.
  *  Power: -11.5dBm +- 1dB
@@ -100,44 +433,49 @@ static openr2_tone_gen_descriptor_t r2_mf_back_digit_tones[15];
  *  Mismatch between the start time of a pair of tones: <=1ms.
  *  Mismatch between the end time of a pair of tones: <=1ms.
  */
-static const mf_digit_tones_t r2_mf_fwd_tones[] =
-{
-    {1380.0f, 1500.0f, -11, -11, 1, 0},
-    {1380.0f, 1620.0f, -11, -11, 1, 0},
-    {1500.0f, 1620.0f, -11, -11, 1, 0},
-    {1380.0f, 1740.0f, -11, -11, 1, 0},
-    {1500.0f, 1740.0f, -11, -11, 1, 0},
-    {1620.0f, 1740.0f, -11, -11, 1, 0},
-    {1380.0f, 1860.0f, -11, -11, 1, 0},
-    {1500.0f, 1860.0f, -11, -11, 1, 0},
-    {1620.0f, 1860.0f, -11, -11, 1, 0},
-    {1740.0f, 1860.0f, -11, -11, 1, 0},
-    {1380.0f, 1980.0f, -11, -11, 1, 0},
-    {1500.0f, 1980.0f, -11, -11, 1, 0},
-    {1620.0f, 1980.0f, -11, -11, 1, 0},
-    {1740.0f, 1980.0f, -11, -11, 1, 0},
-    {1860.0f, 1980.0f, -11, -11, 1, 0},
-    {0.0f, 0.0f, 0, 0, 0, 0}
+/* -11dBm0, dbm0_gain_table[-11 - DBM0_GAIN_MIN_LEVEL] */
+#define R2_MF_TX_GAIN               6433
+
+/* An MF digit is its two tones, played until told to stop */
+#define R2_MF_DIGIT_TONES(f1, f2) \
+    {{{DDS_PHASE_RATE(f1), R2_MF_TX_GAIN}, {DDS_PHASE_RATE(f2), R2_MF_TX_GAIN}}, {1*SAMPLE_RATE/1000, 0, 0, 0}, TRUE}
+
+static const openr2_tone_gen_descriptor_t r2_mf_fwd_digit_tones[15] =
+{
+    R2_MF_DIGIT_TONES(1380, 1500),
+    R2_MF_DIGIT_TONES(1380, 1620),
+    R2_MF_DIGIT_TONES(1500, 1620),
+    R2_MF_DIGIT_TONES(1380, 1740),
+    R2_MF_DIGIT_TONES(1500, 1740),
+    R2_MF_DIGIT_TONES(1620, 1740),
+    R2_MF_DIGIT_TONES(1380, 1860),
+    R2_MF_DIGIT_TONES(1500, 1860),
+    R2_MF_DIGIT_TONES(1620, 1860),
+    R2_MF_DIGIT_TONES(1740, 1860),
+    R2_MF_DIGIT_TONES(1380, 1980),
+    R2_MF_DIGIT_TONES(1500, 1980),
+    R2_MF_DIGIT_TONES(1620, 1980),
+    R2_MF_DIGIT_TONES(1740, 1980),
+    R2_MF_DIGIT_TONES(1860, 1980)
 };
 
-static const mf_digit_tones_t r2_mf_back_tones[] =
-{
-    {1140.0f, 1020.0f, -11, -11, 1, 0},
-    {1140.0f,  900.0f, -11, -11, 1, 0},
-    {1020.0f,  900.0f, -11, -11, 1, 0},
-    {1140.0f,  780.0f, -11, -11, 1, 0},
-    {1020.0f,  780.0f, -11, -11, 1, 0},
-    { 900.0f,  780.0f, -11, -11, 1, 0},
-    {1140.0f,  660.0f, -11, -11, 1, 0},
-    {1020.0f,  660.0f, -11, -11, 1, 0},
-    { 900.0f,  660.0f, -11, -11, 1, 0},
-    { 780.0f,  660.0f, -11, -11, 1, 0},
-    {1140.0f,  540.0f, -11, -11, 1, 0},
-    {1020.0f,  540.0f, -11, -11, 1, 0},
-    { 900.0f,  540.0f, -11, -11, 1, 0},
-    { 780.0f,  540.0f, -11, -11, 1, 0},
-    { 660.0f,  540.0f, -11, -11, 1, 0},
-    {0.0f, 0.0f, 0, 0, 0, 0}
+static const openr2_tone_gen_descriptor_t r2_mf_back_digit_tones[15] =
+{
+    R2_MF_DIGIT_TONES(1140, 1020),
+    R2_MF_DIGIT_TONES(1140,  900),
+    R2_MF_DIGIT_TONES(1020,  900),
+    R2_MF_DIGIT_TONES(1140,  780),
+    R2_MF_DIGIT_TONES(1020,  780),
+    R2_MF_DIGIT_TONES( 900,  780),
+    R2_MF_DIGIT_TONES(1140,  660),
+    R2_MF_DIGIT_TONES(1020,  660),
+    R2_MF_DIGIT_TONES( 900,  660),
+    R2_MF_DIGIT_TONES( 780,  660),
+    R2_MF_DIGIT_TONES(1140,  540),
+    R2_MF_DIGIT_TONES(1020,  540),
+    R2_MF_DIGIT_TONES( 900,  540),
+    R2_MF_DIGIT_TONES( 780,  540),
+    R2_MF_DIGIT_TONES( 660,  540)
 };
 
 /* The order of the digits here must match the lists above */
@@ -146,25 +484,57 @@ static const char r2_mf_tone_codes[] = "1234567890BCDEF";
 #define R2_MF_THRESHOLD             5.0e8f
 #define R2_MF_TWIST                 5.0f    /* 7dB */
 #define R2_MF_RELATIVE_PEAK         12.6f   /* 11dB */
-#define R2_MF_SAMPLES_PER_BLOCK     133
+#define R2_MF_SAMPLES_PER_BLOCK     OR2_MF_RX_BLOCK_SAMPLES
+/* No filter output can exceed the sum of the magnitudes of its input samples
+   (plus one unit per sample for the fixed point rounding), so blocks summing
+   below this can never reach R2_MF_THRESHOLD, with plenty of room to spare.
+   Both are for R2_MF_SAMPLES_PER_BLOCK samples, a tone's energy grows with the
+   square of the block length and its magnitude sum in proportion to it. */
+#define R2_MF_SILENCE_SUM           11000
 
-static openr2_goertzel_descriptor_t mf_fwd_detect_desc[6];
-static openr2_goertzel_descriptor_t mf_back_detect_desc[6];
+/* The filter coefficients, 2cos(2*pi*f/SAMPLE_RATE), are worked out ahead of
+   time so nothing needs setting up before the first detector is created. Each
+   entry has the single precision value and the same value in Q14, for fixed
+   point builds. */
+#if defined(OR2_USE_FIXED_POINT)
+#define GOERTZEL_DESCRIPTOR(fac, qfac, samples) {qfac, samples}
+#else
+#define GOERTZEL_DESCRIPTOR(fac, qfac, samples) {fac, samples}
+#endif
 
-static const float r2_mf_fwd_frequencies[] =
+static const openr2_goertzel_descriptor_t mf_fwd_detect_desc[6] =
 {
-    1380.0f, 1500.0f, 1620.0f, 1740.0f, 1860.0f, 1980.0f
+    GOERTZEL_DESCRIPTOR(0.93585968f, 15333, R2_MF_SAMPLES_PER_BLOCK),     /* 1380Hz */
+    GOERTZEL_DESCRIPTOR(0.765366852f, 12540, R2_MF_SAMPLES_PER_BLOCK),    /* 1500Hz */
+    GOERTZEL_DESCRIPTOR(0.588080585f, 9635, R2_MF_SAMPLES_PER_BLOCK),     /* 1620Hz */
+    GOERTZEL_DESCRIPTOR(0.405574679f, 6645, R2_MF_SAMPLES_PER_BLOCK),     /* 1740Hz */
+    GOERTZEL_DESCRIPTOR(0.219468623f, 3596, R2_MF_SAMPLES_PER_BLOCK),     /* 1860Hz */
+    GOERTZEL_DESCRIPTOR(0.031414561f, 515, R2_MF_SAMPLES_PER_BLOCK)       /* 1980Hz */
 };
 
-static const float r2_mf_back_frequencies[] =
+static const openr2_goertzel_descriptor_t mf_back_detect_desc[6] =
 {
-    1140.0f, 1020.0f,  900.0f,  780.0f,  660.0f,  540.0f
+    GOERTZEL_DESCRIPTOR(1.2504853f, 20488, R2_MF_SAMPLES_PER_BLOCK),      /* 1140Hz */
+    GOERTZEL_DESCRIPTOR(1.39182568f, 22804, R2_MF_SAMPLES_PER_BLOCK),     /* 1020Hz */
+    GOERTZEL_DESCRIPTOR(1.52081192f, 24917, R2_MF_SAMPLES_PER_BLOCK),     /*  900Hz */
+    GOERTZEL_DESCRIPTOR(1.63629949f, 26809, R2_MF_SAMPLES_PER_BLOCK),     /*  780Hz */
+    GOERTZEL_DESCRIPTOR(1.73726296f, 28463, R2_MF_SAMPLES_PER_BLOCK),     /*  660Hz */
+    GOERTZEL_DESCRIPTOR(1.82280648f, 29865, R2_MF_SAMPLES_PER_BLOCK)      /*  540Hz */
 };
 
 /* Use codes '1' to 'F' for the R2 signals 1 to 15, except for signal 'A'.
    Use '0' for this, so the codes match the digits 0-9. */
 static const char r2_mf_positions[] = "1247B-358C--69D---0E----F";
 
+/* All the MF tones are made of multiples of 60Hz, so they repeat every 400
+   samples (3 periods of 60Hz at 8000 samples/second). The first 400 samples of
+   every tone, A-law encoded, are kept here so sending a tone is just copying
+   them over and over. The cache is shared by everyone and never changes once
+   published. */
+#define MF_TX_CACHE_SAMPLES         400
+
+static uint8_t *volatile mf_tx_cache = NULL;
+
 OR2_DECLARE(int) openr2_mf_tx(openr2_mf_tx_state_t *s, int16_t amp[], int samples)
 {
     int len;
@@ -192,6 +562,11 @@ OR2_DECLARE(int) openr2_mf_tx_put(openr2_mf_tx_state_t *s, char digit)
         else
             tone_gen_init(&s->tone, &r2_mf_back_digit_tones[cp - r2_mf_tone_codes]);
         s->digit = digit;
+        if (mf_tx_cache)
+            s->cached = &mf_tx_cache[(((s->fwd)  ?  0  :  15) + (cp - r2_mf_tone_codes))*MF_TX_CACHE_SAMPLES];
+        else
+            s->cached = NULL;
+        s->cached_pos = 0;
     }
     else
     {
@@ -202,9 +577,6 @@ OR2_DECLARE(int) openr2_mf_tx_put(openr2_mf_tx_state_t *s, char digit)
 
 OR2_DECLARE(openr2_mf_tx_state_t *) openr2_mf_tx_init(openr2_mf_tx_state_t *s, int fwd)
 {
-    int i;
-    const mf_digit_tones_t *tones;
-
     if (s == NULL)
     {
         if ((s = (openr2_mf_tx_state_t *) malloc(sizeof(*s))) == NULL)
@@ -212,293 +584,1397 @@ OR2_DECLARE(openr2_mf_tx_state_t *) openr2_mf_tx_init(openr2_mf_tx_state_t *s, i
     }
     memset(s, 0, sizeof(*s));
 
-    if (!r2_mf_gen_inited)
+    s->fwd = fwd;
+    return s;
+}
+
+int openr2_mf_tx_cache_init(void)
+{
+    openr2_tone_gen_state_t tone;
+    int16_t amp[MF_TX_CACHE_SAMPLES];
+    uint8_t *cache;
+    int i;
+
+    if (mf_tx_cache)
+        return 0;
+    if ((cache = (uint8_t *) malloc(2*15*MF_TX_CACHE_SAMPLES)) == NULL)
+        return -1;
+    for (i = 0;  i < 2*15;  i++)
+    {
+        tone_gen_init(&tone, (i < 15)  ?  &r2_mf_fwd_digit_tones[i]  :  &r2_mf_back_digit_tones[i - 15]);
+        tone_gen(&tone, amp, MF_TX_CACHE_SAMPLES);
+        openr2_linear_to_alaw_n(amp, &cache[i*MF_TX_CACHE_SAMPLES], MF_TX_CACHE_SAMPLES);
+    }
+    /* someone else may have beaten us to it, theirs is as good as ours */
+    if (!openr2_atomic_cas_ptr(&mf_tx_cache, NULL, cache))
+        free(cache);
+    return 0;
+}
+
+OR2_DECLARE(int) openr2_mf_tx_alaw(openr2_mf_tx_state_t *s, uint8_t alaw[], int samples)
+{
+    int16_t amp[MF_TX_CACHE_SAMPLES];
+    int len;
+    int i;
+
+    if (s->digit == 0)
+    {
+        memset(alaw, linear_to_alaw_table[0], samples);
+        return samples;
+    }
+    if (s->cached == NULL)
     {
-        i = 0;
-        tones = r2_mf_fwd_tones;
-        while (tones->on_time)
+        /* no cache, synthesize and encode */
+        for (len = 0;  len < samples;  len += i)
         {
-            make_tone_gen_descriptor(&r2_mf_fwd_digit_tones[i++],
-                                     (int) tones->f1,
-                                     tones->level1,
-                                     (int) tones->f2,
-                                     tones->level2,
-                                     tones->on_time,
-                                     tones->off_time,
-                                     0,
-                                     0,
-                                     (tones->off_time == 0));
-            tones++;
+            i = samples - len;
+            if (i > MF_TX_CACHE_SAMPLES)
+                i = MF_TX_CACHE_SAMPLES;
+            if ((i = tone_gen(&s->tone, amp, i)) <= 0)
+                break;
+            openr2_linear_to_alaw_n(amp, &alaw[len], i);
         }
-        i = 0;
-        tones = r2_mf_back_tones;
-        while (tones->on_time)
+        return len;
+    }
+    for (len = 0;  len < samples;  len += i)
+    {
+        i = MF_TX_CACHE_SAMPLES - s->cached_pos;
+        if (i > samples - len)
+            i = samples - len;
+        memcpy(&alaw[len], &s->cached[s->cached_pos], i);
+        s->cached_pos += i;
+        if (s->cached_pos >= MF_TX_CACHE_SAMPLES)
+            s->cached_pos = 0;
+    }
+    return len;
+}
+
+/* Decide which digit, if any, the energies of an MF detection block represent */
+static int mf_rx_block_digit(const float energy[6], float threshold)
+{
+    int i;
+    int best;
+    int second_best;
+
+    /* Find the two highest energies */
+    if (energy[0] > energy[1])
+    {
+        best = 0;
+        second_best = 1;
+    }
+    else
+    {
+        best = 1;
+        second_best = 0;
+    }
+    
+    for (i = 2;  i < 6;  i++)
+    {
+        if (energy[i] >= energy[best])
         {
-            make_tone_gen_descriptor(&r2_mf_back_digit_tones[i++],
-                                     (int) tones->f1,
-                                     tones->level1,
-                                     (int) tones->f2,
-                                     tones->level2,
-                                     tones->on_time,
-                                     tones->off_time,
-                                     0,
-                                     0,
-                                     (tones->off_time == 0));
-            tones++;
+            second_best = best;
+            best = i;
+        }
+        else if (energy[i] >= energy[second_best])
+        {
+            second_best = i;
         }
-        r2_mf_gen_inited = TRUE;
     }
-    s->fwd = fwd;
-    return s;
+    /* Basic signal level and twist tests */
+    if (energy[best] < threshold
+        ||
+        energy[second_best] < threshold
+        ||
+        energy[best] >= energy[second_best]*R2_MF_TWIST
+        ||
+        energy[best]*R2_MF_TWIST <= energy[second_best])
+    {
+        return 0;
+    }
+    /* Relative peak test */
+    for (i = 0;  i < 6;  i++)
+    {
+        if (i != best  &&  i != second_best)
+        {
+            if (energy[i]*R2_MF_RELATIVE_PEAK >= energy[second_best])
+            {
+                /* The best two are not clearly the best */
+                return 0;
+            }
+        }
+    }
+    /* Get the values into ascending order */
+    if (second_best < best)
+    {
+        i = best;
+        best = second_best;
+        second_best = i;
+    }
+    return r2_mf_positions[best*5 + second_best - 1];
 }
 
-OR2_DECLARE(int) openr2_mf_rx(openr2_mf_rx_state_t *s, const int16_t amp[], int samples)
+/* Take the decision of a detection block ending at the given sample, noting it
+   down as an event if the tone changed and the caller wants them */
+static void mf_rx_decide(openr2_mf_rx_state_t *s, int digit, int sample, openr2_mf_rx_event_t events[], int max_events, int *nevents)
+{
+    if (events  &&  digit != s->current_digit  &&  *nevents < max_events)
+    {
+        events[*nevents].digit = digit;
+        events[*nevents].sample = sample;
+        (*nevents)++;
+    }
+    s->current_digit = digit;
+}
+
+static int mf_rx(openr2_mf_rx_state_t *s, const int16_t amp[], const uint8_t alaw[], int samples,
+                 openr2_mf_rx_event_t events[], int max_events, int *nevents)
 {
     float energy[6];
-    float famp;
-    float v1;
     int i;
-    int j;
     int sample;
-    int best;
-    int second_best;
-    int hit;
     int hit_digit;
     int limit;
+    int sum;
 
-    hit = 0;
     hit_digit = 0;
     for (sample = 0;  sample < samples;  sample = limit)
+    {
+        if ((samples - sample) >= (s->block - s->current_sample))
+            limit = sample + (s->block - s->current_sample);
+        else
+            limit = samples;
+        if (s->silence_sum >= 0)
+        {
+            /* The block has been quiet so far. Keep the samples aside rather than
+               running the filters, and only run them if the block turns out to
+               have enough in it to possibly hold a tone. */
+            sum = s->silence_sum;
+            for (i = sample;  i < limit;  i++)
+            {
+                s->replay[s->current_sample + i - sample] = detector_sample(amp, alaw, i);
+                sum += abs(s->replay[s->current_sample + i - sample]);
+            }
+            if (sum > s->silence_limit)
+            {
+                dsp->goertzel_update_mf(s->out, s->replay, NULL, s->current_sample + limit - sample);
+                s->silence_sum = -1;
+            }
+            else
+            {
+                s->silence_sum = sum;
+            }
+        }
+        else if (alaw)
+        {
+            dsp->goertzel_update_mf(s->out, NULL, &alaw[sample], limit - sample);
+        }
+        else
+        {
+            dsp->goertzel_update_mf(s->out, &amp[sample], NULL, limit - sample);
+        }
+        s->current_sample += (limit - sample);
+        if (s->current_sample < s->block)
+            continue;
+
+        /* We are at the end of an MF detection block */
+        if (s->silence_sum >= 0)
+        {
+            /* Too quiet for any tone, the filters were never needed */
+            hit_digit = 0;
+        }
+        else
+        {
+            for (i = 0;  i < 6;  i++)
+                energy[i] = goertzel_result(&s->out[i]);
+            hit_digit = mf_rx_block_digit(energy, s->threshold);
+        }
+        mf_rx_decide(s, hit_digit, limit - 1, events, max_events, nevents);
+        s->silence_sum = 0;
+
+        /* Reinitialise the detector for the next block */
+        for (i = 0;  i < 6;  i++)
+            goertzel_reset(&s->out[i]);
+        s->current_sample = 0;
+    }
+    return hit_digit;
+}
+
+/* Overlapping blocks. The last block of samples is kept in the replay ring, and
+   every hop samples the filters are run over all of it from scratch. */
+static int mf_rx_sliding(openr2_mf_rx_state_t *s, const int16_t amp[], const uint8_t alaw[], int samples,
+                         openr2_mf_rx_event_t events[], int max_events, int *nevents)
+{
+    float energy[6];
+    int16_t x;
+    int i;
+    int j;
+
+    for (j = 0;  j < samples;  j++)
+    {
+        x = detector_sample(amp, alaw, j);
+        s->silence_sum += abs(x) - abs(s->replay[s->replay_pos]);
+        s->replay[s->replay_pos] = x;
+        if (++s->replay_pos >= s->block)
+            s->replay_pos = 0;
+        if (++s->current_sample < s->hop)
+            continue;
+        s->current_sample = 0;
+
+        if (s->silence_sum <= s->silence_limit)
+        {
+            /* Too quiet for any tone */
+            mf_rx_decide(s, 0, j, events, max_events, nevents);
+            continue;
+        }
+        for (i = 0;  i < 6;  i++)
+            goertzel_reset(&s->out[i]);
+        dsp->goertzel_update_mf(s->out, &s->replay[s->replay_pos], NULL, s->block - s->replay_pos);
+        dsp->goertzel_update_mf(s->out, s->replay, NULL, s->replay_pos);
+        for (i = 0;  i < 6;  i++)
+            energy[i] = goertzel_result(&s->out[i]);
+        mf_rx_decide(s, mf_rx_block_digit(energy, s->threshold), j, events, max_events, nevents);
+    }
+    /* Unlike back to back blocks, always report the latest decision, as there
+       may be a few of them in a single call */
+    return s->current_digit;
+}
+
+static void alaw_to_linear_scalar(const uint8_t alaw[], int16_t linear[], int samples)
+{
+    int i;
+
+    for (i = 0;  i < samples;  i++)
+        linear[i] = openr2_alaw_to_linear_table[alaw[i]];
+}
+
+static void linear_to_alaw_scalar(const int16_t linear[], uint8_t alaw[], int samples)
+{
+    int i;
+
+    for (i = 0;  i < samples;  i++)
+        alaw[i] = linear_to_alaw_table[(uint16_t) linear[i] >> 4];
+}
+
+#if defined(OR2_DSP_X86)
+/* The tables are gathered a 32 bit word at a time, the entry wanted being
+   shifted down, so nothing past their ends is read */
+static OR2_DSP_TARGET_AVX2 void alaw_to_linear_avx2(const uint8_t alaw[], int16_t linear[], int samples)
+{
+    __m256i index;
+    __m256i x;
+    int i;
+
+    for (i = 0;  i + 8 <= samples;  i += 8)
+    {
+        index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) &alaw[i]));
+        x = _mm256_i32gather_epi32((const int *) openr2_alaw_to_linear_table, _mm256_srli_epi32(index, 1), 4);
+        x = _mm256_srlv_epi32(x, _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(1)), 4));
+        x = _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16);
+        x = _mm256_permute4x64_epi64(_mm256_packs_epi32(x, x), 0x08);
+        _mm_storeu_si128((__m128i *) &linear[i], _mm256_castsi256_si128(x));
+    }
+    alaw_to_linear_scalar(&alaw[i], &linear[i], samples - i);
+}
+
+static OR2_DSP_TARGET_AVX2 __m256i linear_to_alaw_gather_avx2(__m256i index)
+{
+    __m256i x;
+
+    x = _mm256_i32gather_epi32((const int *) linear_to_alaw_table, _mm256_srli_epi32(index, 2), 4);
+    x = _mm256_srlv_epi32(x, _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(3)), 3));
+    return _mm256_and_si256(x, _mm256_set1_epi32(0xFF));
+}
+
+static OR2_DSP_TARGET_AVX2 void linear_to_alaw_avx2(const int16_t linear[], uint8_t alaw[], int samples)
+{
+    __m256i x;
+    __m256i lo;
+    __m256i hi;
+    int i;
+
+    for (i = 0;  i + 16 <= samples;  i += 16)
+    {
+        x = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *) &linear[i]), 4);
+        lo = linear_to_alaw_gather_avx2(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x)));
+        hi = linear_to_alaw_gather_avx2(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1)));
+        x = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm_storeu_si128((__m128i *) &alaw[i], _mm_packus_epi16(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+    }
+    linear_to_alaw_scalar(&linear[i], &alaw[i], samples - i);
+}
+#endif
+
+OR2_DECLARE(void) openr2_alaw_to_linear_n(const uint8_t alaw[], int16_t linear[], int samples)
+{
+    dsp->alaw_to_linear(alaw, linear, samples);
+}
+
+OR2_DECLARE(void) openr2_linear_to_alaw_n(const int16_t linear[], uint8_t alaw[], int samples)
+{
+    dsp->linear_to_alaw(linear, alaw, samples);
+}
+
+OR2_DECLARE(int) openr2_mf_rx(openr2_mf_rx_state_t *s, const int16_t amp[], int samples)
+{
+    if (s->hop < s->block)
+        return mf_rx_sliding(s, amp, NULL, samples, NULL, 0, NULL);
+    return mf_rx(s, amp, NULL, samples, NULL, 0, NULL);
+}
+
+OR2_DECLARE(int) openr2_mf_rx_alaw(openr2_mf_rx_state_t *s, const uint8_t alaw[], int samples)
+{
+    if (s->hop < s->block)
+        return mf_rx_sliding(s, NULL, alaw, samples, NULL, 0, NULL);
+    return mf_rx(s, NULL, alaw, samples, NULL, 0, NULL);
+}
+
+OR2_DECLARE(int) openr2_mf_rx_events(openr2_mf_rx_state_t *s, const int16_t amp[], int samples, openr2_mf_rx_event_t events[], int max_events)
+{
+    int nevents;
+
+    nevents = 0;
+    if (s->hop < s->block)
+        mf_rx_sliding(s, amp, NULL, samples, events, max_events, &nevents);
+    else
+        mf_rx(s, amp, NULL, samples, events, max_events, &nevents);
+    return nevents;
+}
+
+OR2_DECLARE(int) openr2_mf_rx_alaw_events(openr2_mf_rx_state_t *s, const uint8_t alaw[], int samples, openr2_mf_rx_event_t events[], int max_events)
+{
+    int nevents;
+
+    nevents = 0;
+    if (s->hop < s->block)
+        mf_rx_sliding(s, NULL, alaw, samples, events, max_events, &nevents);
+    else
+        mf_rx(s, NULL, alaw, samples, events, max_events, &nevents);
+    return nevents;
+}
+
+OR2_DECLARE(int) openr2_mf_rx_get_digit(openr2_mf_rx_state_t *s)
+{
+    return s->current_digit;
+}
+
+OR2_DECLARE(int) openr2_mf_rx_set_block(openr2_mf_rx_state_t *s, int block, int hop)
+{
+    int i;
+
+    if (block < OR2_MF_RX_MIN_BLOCK_SAMPLES  ||  block > OR2_MF_RX_BLOCK_SAMPLES)
+        return -1;
+    if (hop == 0)
+        hop = block;
+    if (hop < 1  ||  hop > block)
+        return -1;
+    s->block = block;
+    s->hop = hop;
+    s->threshold = R2_MF_THRESHOLD*((float) (block*block)/(float) (R2_MF_SAMPLES_PER_BLOCK*R2_MF_SAMPLES_PER_BLOCK));
+    s->silence_limit = R2_MF_SILENCE_SUM*block/R2_MF_SAMPLES_PER_BLOCK;
+    /* Start over, with a silent history for sliding blocks */
+    for (i = 0;  i < 6;  i++)
+        goertzel_reset(&s->out[i]);
+    memset(s->replay, 0, sizeof(s->replay));
+    s->replay_pos = 0;
+    s->silence_sum = 0;
+    s->current_sample = 0;
+    s->current_digit = 0;
+    return 0;
+}
+
+OR2_DECLARE(openr2_mf_rx_state_t *) openr2_mf_rx_init(openr2_mf_rx_state_t *s, int fwd)
+{
+    int i;
+
+    if (s == NULL)
+    {
+        if ((s = (openr2_mf_rx_state_t *) malloc(sizeof(*s))) == NULL)
+            return NULL;
+    }
+    memset(s, 0, sizeof(*s));
+
+    s->fwd = fwd;
+
+    if (fwd)
+    {
+        for (i = 0;  i < 6;  i++)
+            goertzel_init(&s->out[i], &mf_fwd_detect_desc[i]);
+    }
+    else
+    {
+        for (i = 0;  i < 6;  i++)
+            goertzel_init(&s->out[i], &mf_back_detect_desc[i]);
+    }
+    openr2_mf_rx_set_block(s, R2_MF_SAMPLES_PER_BLOCK, 0);
+    return s;
+}
+
+static void mf_rx_dual(openr2_mf_rx_dual_state_t *s, const int16_t amp[], const uint8_t alaw[], int samples,
+                       int *fwd_digit, int *back_digit)
+{
+    float energy[12];
+    int i;
+    int sample;
+    int limit;
+    int sum;
+
+    *fwd_digit = 0;
+    *back_digit = 0;
+    for (sample = 0;  sample < samples;  sample = limit)
     {
         if ((samples - sample) >= (R2_MF_SAMPLES_PER_BLOCK - s->current_sample))
             limit = sample + (R2_MF_SAMPLES_PER_BLOCK - s->current_sample);
         else
             limit = samples;
-        for (j = sample;  j < limit;  j++)
+        /* The same silence skipping as mf_rx(), done once for both directions */
+        if (s->silence_sum >= 0)
         {
-            famp = amp[j];
-            /* With GCC 2.95, the following unrolled code seems to take about 35%
-               (rough estimate) as long as a neat little 0-5 loop */
-            v1 = s->out[0].v2;
-            s->out[0].v2 = s->out[0].v3;
-            s->out[0].v3 = s->out[0].fac*s->out[0].v2 - v1 + famp;
-    
-            v1 = s->out[1].v2;
-            s->out[1].v2 = s->out[1].v3;
-            s->out[1].v3 = s->out[1].fac*s->out[1].v2 - v1 + famp;
-    
-            v1 = s->out[2].v2;
-            s->out[2].v2 = s->out[2].v3;
-            s->out[2].v3 = s->out[2].fac*s->out[2].v2 - v1 + famp;
-    
-            v1 = s->out[3].v2;
-            s->out[3].v2 = s->out[3].v3;
-            s->out[3].v3 = s->out[3].fac*s->out[3].v2 - v1 + famp;
-    
-            v1 = s->out[4].v2;
-            s->out[4].v2 = s->out[4].v3;
-            s->out[4].v3 = s->out[4].fac*s->out[4].v2 - v1 + famp;
-    
-            v1 = s->out[5].v2;
-            s->out[5].v2 = s->out[5].v3;
-            s->out[5].v3 = s->out[5].fac*s->out[5].v2 - v1 + famp;
+            sum = s->silence_sum;
+            for (i = sample;  i < limit;  i++)
+            {
+                s->replay[s->current_sample + i - sample] = detector_sample(amp, alaw, i);
+                sum += abs(s->replay[s->current_sample + i - sample]);
+            }
+            if (sum > R2_MF_SILENCE_SUM)
+            {
+                dsp->goertzel_update_mf_dual(s->out, s->replay, NULL, s->current_sample + limit - sample);
+                s->silence_sum = -1;
+            }
+            else
+            {
+                s->silence_sum = sum;
+            }
+        }
+        else if (alaw)
+        {
+            dsp->goertzel_update_mf_dual(s->out, NULL, &alaw[sample], limit - sample);
+        }
+        else
+        {
+            dsp->goertzel_update_mf_dual(s->out, &amp[sample], NULL, limit - sample);
         }
         s->current_sample += (limit - sample);
         if (s->current_sample < R2_MF_SAMPLES_PER_BLOCK)
             continue;
 
         /* We are at the end of an MF detection block */
-        /* Find the two highest energies */
-        energy[0] = goertzel_result(&s->out[0]);
-        energy[1] = goertzel_result(&s->out[1]);
-        if (energy[0] > energy[1])
+        if (s->silence_sum >= 0)
         {
-            best = 0;
-            second_best = 1;
+            *fwd_digit = 0;
+            *back_digit = 0;
         }
         else
         {
-            best = 1;
-            second_best = 0;
+            for (i = 0;  i < 12;  i++)
+                energy[i] = goertzel_result(&s->out[i]);
+            *fwd_digit = mf_rx_block_digit(energy, R2_MF_THRESHOLD);
+            *back_digit = mf_rx_block_digit(&energy[6], R2_MF_THRESHOLD);
         }
-        
-        for (i = 2;  i < 6;  i++)
+        s->silence_sum = 0;
+        for (i = 0;  i < 12;  i++)
+            goertzel_reset(&s->out[i]);
+        s->current_sample = 0;
+    }
+}
+
+OR2_DECLARE(openr2_mf_rx_dual_state_t *) openr2_mf_rx_dual_init(openr2_mf_rx_dual_state_t *s)
+{
+    int i;
+
+    if (s == NULL)
+    {
+        if ((s = (openr2_mf_rx_dual_state_t *) malloc(sizeof(*s))) == NULL)
+            return NULL;
+    }
+    memset(s, 0, sizeof(*s));
+    for (i = 0;  i < 6;  i++)
+    {
+        goertzel_init(&s->out[i], &mf_fwd_detect_desc[i]);
+        goertzel_init(&s->out[i + 6], &mf_back_detect_desc[i]);
+    }
+    return s;
+}
+
+OR2_DECLARE(void) openr2_mf_rx_dual(openr2_mf_rx_dual_state_t *s, const int16_t amp[], int samples, int *fwd_digit, int *back_digit)
+{
+    mf_rx_dual(s, amp, NULL, samples, fwd_digit, back_digit);
+}
+
+OR2_DECLARE(void) openr2_mf_rx_dual_alaw(openr2_mf_rx_dual_state_t *s, const uint8_t alaw[], int samples, int *fwd_digit, int *back_digit)
+{
+    mf_rx_dual(s, NULL, alaw, samples, fwd_digit, back_digit);
+}
+
+/* The channels of a bank are padded to the widest vector any kernel uses */
+#define MF_BANK_LANES               8
+
+OR2_DECLARE(openr2_mf_rx_bank_t *) openr2_mf_rx_bank_new(int channels)
+{
+    openr2_mf_rx_bank_t *bank;
+    int stride;
+    int i;
+
+    if (channels <= 0)
+        return NULL;
+    if ((bank = (openr2_mf_rx_bank_t *) malloc(sizeof(*bank))) == NULL)
+        return NULL;
+    memset(bank, 0, sizeof(*bank));
+    stride = (channels + MF_BANK_LANES - 1)/MF_BANK_LANES*MF_BANK_LANES;
+    bank->channels = channels;
+    bank->stride = stride;
+    bank->fac = (openr2_goertzel_value_t *) calloc(6*stride, sizeof(openr2_goertzel_value_t));
+    bank->v2 = (openr2_goertzel_value_t *) calloc(6*stride, sizeof(openr2_goertzel_value_t));
+    bank->v3 = (openr2_goertzel_value_t *) calloc(6*stride, sizeof(openr2_goertzel_value_t));
+    bank->amp = (openr2_goertzel_value_t *) calloc(R2_MF_SAMPLES_PER_BLOCK*stride, sizeof(openr2_goertzel_value_t));
+    bank->fwd = (int *) calloc(stride, sizeof(int));
+    bank->partial = (int *) calloc(stride, sizeof(int));
+    bank->current_digit = (int *) calloc(stride, sizeof(int));
+    if (!bank->fac || !bank->v2 || !bank->v3 || !bank->amp || !bank->fwd || !bank->partial || !bank->current_digit)
+    {
+        openr2_mf_rx_bank_delete(bank);
+        return NULL;
+    }
+    for (i = 0;  i < channels;  i++)
+        openr2_mf_rx_bank_init(bank, i, FALSE);
+    /* nothing is partial before the first block starts */
+    memset(bank->partial, 0, stride*sizeof(int));
+    return bank;
+}
+
+OR2_DECLARE(void) openr2_mf_rx_bank_delete(openr2_mf_rx_bank_t *bank)
+{
+    if (bank == NULL)
+        return;
+    free(bank->fac);
+    free(bank->v2);
+    free(bank->v3);
+    free(bank->amp);
+    free(bank->fwd);
+    free(bank->partial);
+    free(bank->current_digit);
+    free(bank);
+}
+
+OR2_DECLARE(int) openr2_mf_rx_bank_init(openr2_mf_rx_bank_t *bank, int channel, int fwd)
+{
+    const openr2_goertzel_descriptor_t *desc;
+    int i;
+
+    if (channel < 0  ||  channel >= bank->channels)
+        return -1;
+    desc = (fwd)  ?  mf_fwd_detect_desc  :  mf_back_detect_desc;
+    for (i = 0;  i < 6;  i++)
+    {
+        bank->fac[i*bank->stride + channel] = desc[i].fac;
+        bank->v2[i*bank->stride + channel] = 0;
+        bank->v3[i*bank->stride + channel] = 0;
+    }
+    bank->fwd[channel] = fwd;
+    bank->current_digit[channel] = 0;
+    /* the channel missed the start of the current block, so it sits that block out */
+    bank->partial[channel] = (bank->current_sample != 0);
+    return 0;
+}
+
+OR2_DECLARE(int) openr2_mf_rx_bank(openr2_mf_rx_bank_t *bank, const int16_t *amp[], int samples, int digits[])
+{
+    openr2_goertzel_state_t out;
+    float energy[6];
+    openr2_goertzel_value_t *in;
+    int stride;
+    int hits;
+    int sample;
+    int limit;
+    int len;
+    int c;
+    int i;
+    int j;
+
+    stride = bank->stride;
+    hits = 0;
+    for (c = 0;  c < bank->channels;  c++)
+        digits[c] = 0;
+    for (sample = 0;  sample < samples;  sample = limit)
+    {
+        if ((samples - sample) >= (R2_MF_SAMPLES_PER_BLOCK - bank->current_sample))
+            limit = sample + (R2_MF_SAMPLES_PER_BLOCK - bank->current_sample);
+        else
+            limit = samples;
+        len = limit - sample;
+
+        /* Lay the samples out so a vector of channels can be loaded at once,
+           channels without samples get silence */
+        for (c = 0;  c < bank->channels;  c++)
         {
-            energy[i] = goertzel_result(&s->out[i]);
-            if (energy[i] >= energy[best])
+            in = bank->amp + c;
+            if (amp[c])
             {
-                second_best = best;
-                best = i;
+                for (j = 0;  j < len;  j++)
+                    in[j*stride] = amp[c][sample + j];
             }
-            else if (energy[i] >= energy[second_best])
+            else
             {
-                second_best = i;
+                for (j = 0;  j < len;  j++)
+                    in[j*stride] = 0;
             }
         }
-        /* Basic signal level and twist tests */
-        hit = FALSE;
-        if (energy[best] >= R2_MF_THRESHOLD
-            &&
-            energy[second_best] >= R2_MF_THRESHOLD
-            &&
-            energy[best] < energy[second_best]*R2_MF_TWIST
-            &&
-            energy[best]*R2_MF_TWIST > energy[second_best])
+
+        dsp->goertzel_update_mf_bank(bank->fac, bank->v2, bank->v3, bank->amp, stride, len);
+        bank->current_sample += len;
+        if (bank->current_sample < R2_MF_SAMPLES_PER_BLOCK)
+            continue;
+
+        /* We are at the end of an MF detection block for all the channels */
+        for (c = 0;  c < bank->channels;  c++)
         {
-            /* Relative peak test */
-            hit = TRUE;
             for (i = 0;  i < 6;  i++)
             {
-                if (i != best  &&  i != second_best)
-                {
-                    if (energy[i]*R2_MF_RELATIVE_PEAK >= energy[second_best])
-                    {
-                        /* The best two are not clearly the best */
-                        hit = FALSE;
-                        break;
-                    }
-                }
+                out.fac = bank->fac[i*stride + c];
+                out.v2 = bank->v2[i*stride + c];
+                out.v3 = bank->v3[i*stride + c];
+                energy[i] = goertzel_result(&out);
+                bank->v2[i*stride + c] = 0;
+                bank->v3[i*stride + c] = 0;
+            }
+            if (bank->partial[c])
+            {
+                bank->partial[c] = FALSE;
+                digits[c] = 0;
+            }
+            else
+            {
+                digits[c] = mf_rx_block_digit(energy, R2_MF_THRESHOLD);
             }
+            bank->current_digit[c] = digits[c];
         }
-        if (hit)
+        bank->current_sample = 0;
+    }
+    for (c = 0;  c < bank->channels;  c++)
+    {
+        if (digits[c])
+            hits++;
+    }
+    return hits;
+}
+
+static openr2_goertzel_state_t *goertzel_init(openr2_goertzel_state_t *s, const openr2_goertzel_descriptor_t *t)
+{
+    if (s == NULL)
+    {
+        if ((s = (openr2_goertzel_state_t *) malloc(sizeof(*s))) == NULL)
+            return NULL;
+    }
+    s->v2 =
+    s->v3 = 0;
+    s->fac = t->fac;
+    s->samples = t->samples;
+    s->current_sample = 0;
+    return s;
+}
+
+static void goertzel_reset(openr2_goertzel_state_t *s)
+{
+    s->v2 =
+    s->v3 = 0;
+    s->current_sample = 0;
+}
+
+static float goertzel_result(openr2_goertzel_state_t *s)
+{
+    openr2_goertzel_value_t v1;
+    /* Push a zero through the process to finish things off. */
+    v1 = s->v2;
+    s->v2 = s->v3;
+    s->v3 = goertzel_step(s->fac, v1, s->v2, 0);
+    /* Now calculate the non-recursive side of the filter. */
+    /* The result here is not scaled down to allow for the magnification
+       effect of the filter (the usual DFT magnification effect). */
+#if defined(OR2_USE_FIXED_POINT)
+    /* The states are on the same scale as the floating point ones, so the
+       energy is too, and the same thresholds apply */
+    return (float) ((int64_t) s->v3*s->v3 + (int64_t) s->v2*s->v2 - ((((int64_t) s->v2*s->v3) >> GOERTZEL_Q)*s->fac));
+#else
+    return s->v3*s->v3 + s->v2*s->v2 - s->v2*s->v3*s->fac;
+#endif
+}
+
+/* Run the six MF Goertzel filters over the same samples. The filters share the
+   input and the recurrence, so the vector versions run them side by side in
+   lanes (the two spare lanes run with a zero coefficient and are discarded).
+   Every lane does exactly the same single precision operations, in the same
+   order, as the scalar code, so the energies and therefore the detection
+   decisions do not depend on which version runs. The state is loaded and
+   stored back once per call rather than once per sample. */
+static void goertzel_update_mf_scalar(openr2_goertzel_state_t s[6], const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    openr2_goertzel_value_t fac[6];
+    openr2_goertzel_value_t v2[6];
+    openr2_goertzel_value_t v3[6];
+    openr2_goertzel_value_t v1;
+    openr2_goertzel_value_t famp;
+    int i;
+    int k;
+
+    /* Plain arrays rather than the state structures, so the compiler is free
+       to keep them in registers or vectorise the inner loop */
+    for (k = 0;  k < 6;  k++)
+    {
+        fac[k] = s[k].fac;
+        v2[k] = s[k].v2;
+        v3[k] = s[k].v3;
+    }
+    for (i = 0;  i < samples;  i++)
+    {
+        famp = detector_sample(amp, alaw, i);
+        for (k = 0;  k < 6;  k++)
+        {
+            v1 = v2[k];
+            v2[k] = v3[k];
+            v3[k] = goertzel_step(fac[k], v1, v2[k], famp);
+        }
+    }
+    for (k = 0;  k < 6;  k++)
+    {
+        s[k].v2 = v2[k];
+        s[k].v3 = v3[k];
+    }
+}
+
+/* Run the four row and the four column DTMF Goertzel filters over the same
+   (already notch filtered) samples. As for the MF filters, every lane of the
+   vector versions does the same single precision operations in the same order
+   as the scalar code, so the decisions do not change. */
+static void goertzel_update_dtmf_scalar(openr2_goertzel_state_t row[4], openr2_goertzel_state_t col[4], const openr2_goertzel_value_t famp[], int samples)
+{
+    openr2_goertzel_value_t fac[8];
+    openr2_goertzel_value_t v2[8];
+    openr2_goertzel_value_t v3[8];
+    openr2_goertzel_value_t v1;
+    int i;
+    int k;
+
+    for (k = 0;  k < 4;  k++)
+    {
+        fac[k] = row[k].fac;
+        v2[k] = row[k].v2;
+        v3[k] = row[k].v3;
+        fac[k + 4] = col[k].fac;
+        v2[k + 4] = col[k].v2;
+        v3[k + 4] = col[k].v3;
+    }
+    for (i = 0;  i < samples;  i++)
+    {
+        for (k = 0;  k < 8;  k++)
+        {
+            v1 = v2[k];
+            v2[k] = v3[k];
+            v3[k] = goertzel_step(fac[k], v1, v2[k], famp[i]);
+        }
+    }
+    for (k = 0;  k < 4;  k++)
+    {
+        row[k].v2 = v2[k];
+        row[k].v3 = v3[k];
+        col[k].v2 = v2[k + 4];
+        col[k].v3 = v3[k + 4];
+    }
+}
+
+/* Run the six forward and the six backward MF filters over the same samples, to
+   watch both directions of a timeslot in one pass. The same goes as for the six
+   filters of one direction, every lane does exactly what the scalar code does. */
+static void goertzel_update_mf_dual_scalar(openr2_goertzel_state_t s[12], const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    openr2_goertzel_value_t fac[12];
+    openr2_goertzel_value_t v2[12];
+    openr2_goertzel_value_t v3[12];
+    openr2_goertzel_value_t v1;
+    openr2_goertzel_value_t famp;
+    int i;
+    int k;
+
+    for (k = 0;  k < 12;  k++)
+    {
+        fac[k] = s[k].fac;
+        v2[k] = s[k].v2;
+        v3[k] = s[k].v3;
+    }
+    for (i = 0;  i < samples;  i++)
+    {
+        famp = detector_sample(amp, alaw, i);
+        for (k = 0;  k < 12;  k++)
+        {
+            v1 = v2[k];
+            v2[k] = v3[k];
+            v3[k] = goertzel_step(fac[k], v1, v2[k], famp);
+        }
+    }
+    for (k = 0;  k < 12;  k++)
+    {
+        s[k].v2 = v2[k];
+        s[k].v3 = v3[k];
+    }
+}
+
+/* Run the six MF filters of every channel of a detector bank. The filter
+   states are laid out filter by filter, stride channels each, and the samples
+   sample by sample, so the vector versions run neighbouring channels in their
+   lanes, each lane doing what the scalar code does for its channel. */
+static void goertzel_update_mf_bank_scalar(const openr2_goertzel_value_t fac[], openr2_goertzel_value_t v2[], openr2_goertzel_value_t v3[], const openr2_goertzel_value_t amp[], int stride, int samples)
+{
+    openr2_goertzel_value_t v1;
+    int c;
+    int i;
+    int k;
+
+    for (k = 0;  k < 6*stride;  k++)
+    {
+        c = k%stride;
+        for (i = 0;  i < samples;  i++)
+        {
+            v1 = v2[k];
+            v2[k] = v3[k];
+            v3[k] = goertzel_step(fac[k], v1, v2[k], amp[i*stride + c]);
+        }
+    }
+}
+
+#if defined(OR2_USE_FIXED_POINT)
+/* The vector Goertzel kernels are single precision only */
+#define goertzel_update_mf_sse2     goertzel_update_mf_scalar
+#define goertzel_update_dtmf_sse2   goertzel_update_dtmf_scalar
+#define goertzel_update_mf_dual_sse2 goertzel_update_mf_dual_scalar
+#define goertzel_update_mf_bank_sse2 goertzel_update_mf_bank_scalar
+#define goertzel_update_mf_avx2     goertzel_update_mf_scalar
+#define goertzel_update_dtmf_avx2   goertzel_update_dtmf_scalar
+#define goertzel_update_mf_dual_avx2 goertzel_update_mf_dual_scalar
+#define goertzel_update_mf_bank_avx2 goertzel_update_mf_bank_scalar
+#define goertzel_update_mf_neon     goertzel_update_mf_scalar
+#define goertzel_update_dtmf_neon   goertzel_update_dtmf_scalar
+#define goertzel_update_mf_dual_neon goertzel_update_mf_dual_scalar
+#define goertzel_update_mf_bank_neon goertzel_update_mf_bank_scalar
+#else
+#if defined(OR2_DSP_X86)
+static OR2_DSP_TARGET_SSE2 void goertzel_update_mf_sse2(openr2_goertzel_state_t s[6], const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    float out[8];
+    __m128 fac_lo;
+    __m128 fac_hi;
+    __m128 v1;
+    __m128 v2_lo;
+    __m128 v2_hi;
+    __m128 v3_lo;
+    __m128 v3_hi;
+    __m128 famp;
+    int i;
+
+    fac_lo = _mm_setr_ps(s[0].fac, s[1].fac, s[2].fac, s[3].fac);
+    fac_hi = _mm_setr_ps(s[4].fac, s[5].fac, 0.0f, 0.0f);
+    v2_lo = _mm_setr_ps(s[0].v2, s[1].v2, s[2].v2, s[3].v2);
+    v2_hi = _mm_setr_ps(s[4].v2, s[5].v2, 0.0f, 0.0f);
+    v3_lo = _mm_setr_ps(s[0].v3, s[1].v3, s[2].v3, s[3].v3);
+    v3_hi = _mm_setr_ps(s[4].v3, s[5].v3, 0.0f, 0.0f);
+    for (i = 0;  i < samples;  i++)
+    {
+        famp = _mm_set1_ps((float) detector_sample(amp, alaw, i));
+        v1 = v2_lo;
+        v2_lo = v3_lo;
+        v3_lo = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_lo, v2_lo), v1), famp);
+        v1 = v2_hi;
+        v2_hi = v3_hi;
+        v3_hi = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_hi, v2_hi), v1), famp);
+    }
+    _mm_storeu_ps(out, v2_lo);
+    _mm_storeu_ps(out + 4, v2_hi);
+    for (i = 0;  i < 6;  i++)
+        s[i].v2 = out[i];
+    _mm_storeu_ps(out, v3_lo);
+    _mm_storeu_ps(out + 4, v3_hi);
+    for (i = 0;  i < 6;  i++)
+        s[i].v3 = out[i];
+}
+
+static OR2_DSP_TARGET_SSE2 void goertzel_update_dtmf_sse2(openr2_goertzel_state_t row[4], openr2_goertzel_state_t col[4], const openr2_goertzel_value_t famp[], int samples)
+{
+    float out[4];
+    __m128 row_fac;
+    __m128 col_fac;
+    __m128 v1;
+    __m128 row_v2;
+    __m128 row_v3;
+    __m128 col_v2;
+    __m128 col_v3;
+    __m128 x;
+    int i;
+
+    row_fac = _mm_setr_ps(row[0].fac, row[1].fac, row[2].fac, row[3].fac);
+    col_fac = _mm_setr_ps(col[0].fac, col[1].fac, col[2].fac, col[3].fac);
+    row_v2 = _mm_setr_ps(row[0].v2, row[1].v2, row[2].v2, row[3].v2);
+    row_v3 = _mm_setr_ps(row[0].v3, row[1].v3, row[2].v3, row[3].v3);
+    col_v2 = _mm_setr_ps(col[0].v2, col[1].v2, col[2].v2, col[3].v2);
+    col_v3 = _mm_setr_ps(col[0].v3, col[1].v3, col[2].v3, col[3].v3);
+    for (i = 0;  i < samples;  i++)
+    {
+        x = _mm_set1_ps(famp[i]);
+        v1 = row_v2;
+        row_v2 = row_v3;
+        row_v3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(row_fac, row_v2), v1), x);
+        v1 = col_v2;
+        col_v2 = col_v3;
+        col_v3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(col_fac, col_v2), v1), x);
+    }
+    _mm_storeu_ps(out, row_v2);
+    for (i = 0;  i < 4;  i++)
+        row[i].v2 = out[i];
+    _mm_storeu_ps(out, row_v3);
+    for (i = 0;  i < 4;  i++)
+        row[i].v3 = out[i];
+    _mm_storeu_ps(out, col_v2);
+    for (i = 0;  i < 4;  i++)
+        col[i].v2 = out[i];
+    _mm_storeu_ps(out, col_v3);
+    for (i = 0;  i < 4;  i++)
+        col[i].v3 = out[i];
+}
+
+static OR2_DSP_TARGET_SSE2 void goertzel_update_mf_dual_sse2(openr2_goertzel_state_t s[12], const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    float out[12];
+    __m128 fac_a;
+    __m128 fac_b;
+    __m128 fac_c;
+    __m128 v1;
+    __m128 v2_a;
+    __m128 v2_b;
+    __m128 v2_c;
+    __m128 v3_a;
+    __m128 v3_b;
+    __m128 v3_c;
+    __m128 famp;
+    int i;
+
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].fac;
+    fac_a = _mm_loadu_ps(out);
+    fac_b = _mm_loadu_ps(out + 4);
+    fac_c = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v2;
+    v2_a = _mm_loadu_ps(out);
+    v2_b = _mm_loadu_ps(out + 4);
+    v2_c = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v3;
+    v3_a = _mm_loadu_ps(out);
+    v3_b = _mm_loadu_ps(out + 4);
+    v3_c = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < samples;  i++)
+    {
+        famp = _mm_set1_ps((float) detector_sample(amp, alaw, i));
+        v1 = v2_a;
+        v2_a = v3_a;
+        v3_a = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_a, v2_a), v1), famp);
+        v1 = v2_b;
+        v2_b = v3_b;
+        v3_b = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_b, v2_b), v1), famp);
+        v1 = v2_c;
+        v2_c = v3_c;
+        v3_c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_c, v2_c), v1), famp);
+    }
+    _mm_storeu_ps(out, v2_a);
+    _mm_storeu_ps(out + 4, v2_b);
+    _mm_storeu_ps(out + 8, v2_c);
+    for (i = 0;  i < 12;  i++)
+        s[i].v2 = out[i];
+    _mm_storeu_ps(out, v3_a);
+    _mm_storeu_ps(out + 4, v3_b);
+    _mm_storeu_ps(out + 8, v3_c);
+    for (i = 0;  i < 12;  i++)
+        s[i].v3 = out[i];
+}
+
+static OR2_DSP_TARGET_SSE2 void goertzel_update_mf_bank_sse2(const openr2_goertzel_value_t fac[], openr2_goertzel_value_t v2[], openr2_goertzel_value_t v3[], const openr2_goertzel_value_t amp[], int stride, int samples)
+{
+    __m128 vfac[6];
+    __m128 vv2[6];
+    __m128 vv3[6];
+    __m128 v1;
+    __m128 famp;
+    int c;
+    int i;
+    int k;
+
+    for (c = 0;  c < stride;  c += 4)
+    {
+        for (k = 0;  k < 6;  k++)
         {
-            /* Get the values into ascending order */
-            if (second_best < best)
+            vfac[k] = _mm_loadu_ps(&fac[k*stride + c]);
+            vv2[k] = _mm_loadu_ps(&v2[k*stride + c]);
+            vv3[k] = _mm_loadu_ps(&v3[k*stride + c]);
+        }
+        for (i = 0;  i < samples;  i++)
+        {
+            famp = _mm_loadu_ps(&amp[i*stride + c]);
+            for (k = 0;  k < 6;  k++)
             {
-                i = best;
-                best = second_best;
-                second_best = i;
+                v1 = vv2[k];
+                vv2[k] = vv3[k];
+                vv3[k] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vfac[k], vv2[k]), v1), famp);
             }
-            best = best*5 + second_best - 1;
-            hit_digit = r2_mf_positions[best];
         }
-        else
+        for (k = 0;  k < 6;  k++)
         {
-            hit_digit = 0;
+            _mm_storeu_ps(&v2[k*stride + c], vv2[k]);
+            _mm_storeu_ps(&v3[k*stride + c], vv3[k]);
         }
-        s->current_digit = hit_digit;
-
-        /* Reinitialise the detector for the next block */
-        for (i = 0;  i < 6;  i++)
-            goertzel_reset(&s->out[i]);
-        s->current_sample = 0;
     }
-    return hit_digit;
 }
 
-OR2_DECLARE(openr2_mf_rx_state_t *) openr2_mf_rx_init(openr2_mf_rx_state_t *s, int fwd)
+/* These only need AVX, but are kept with the AVX2 kernels so there is a
+   single set of 256 bit kernels to pick from */
+static OR2_DSP_TARGET_AVX2 void goertzel_update_mf_avx2(openr2_goertzel_state_t s[6], const int16_t amp[], const uint8_t alaw[], int samples)
 {
+    float out[8];
+    __m256 fac;
+    __m256 v1;
+    __m256 v2;
+    __m256 v3;
+    __m256 famp;
     int i;
-    static int initialised = FALSE;
 
-    if (s == NULL)
+    fac = _mm256_setr_ps(s[0].fac, s[1].fac, s[2].fac, s[3].fac, s[4].fac, s[5].fac, 0.0f, 0.0f);
+    v2 = _mm256_setr_ps(s[0].v2, s[1].v2, s[2].v2, s[3].v2, s[4].v2, s[5].v2, 0.0f, 0.0f);
+    v3 = _mm256_setr_ps(s[0].v3, s[1].v3, s[2].v3, s[3].v3, s[4].v3, s[5].v3, 0.0f, 0.0f);
+    for (i = 0;  i < samples;  i++)
     {
-        if ((s = (openr2_mf_rx_state_t *) malloc(sizeof(*s))) == NULL)
-            return NULL;
+        famp = _mm256_set1_ps((float) detector_sample(amp, alaw, i));
+        v1 = v2;
+        v2 = v3;
+        v3 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(fac, v2), v1), famp);
     }
-    memset(s, 0, sizeof(*s));
+    _mm256_storeu_ps(out, v2);
+    for (i = 0;  i < 6;  i++)
+        s[i].v2 = out[i];
+    _mm256_storeu_ps(out, v3);
+    for (i = 0;  i < 6;  i++)
+        s[i].v3 = out[i];
+}
 
-    s->fwd = fwd;
+static OR2_DSP_TARGET_AVX2 void goertzel_update_dtmf_avx2(openr2_goertzel_state_t row[4], openr2_goertzel_state_t col[4], const openr2_goertzel_value_t famp[], int samples)
+{
+    float out[8];
+    __m256 fac;
+    __m256 v1;
+    __m256 v2;
+    __m256 v3;
+    int i;
 
-    if (!initialised)
+    fac = _mm256_setr_ps(row[0].fac, row[1].fac, row[2].fac, row[3].fac, col[0].fac, col[1].fac, col[2].fac, col[3].fac);
+    v2 = _mm256_setr_ps(row[0].v2, row[1].v2, row[2].v2, row[3].v2, col[0].v2, col[1].v2, col[2].v2, col[3].v2);
+    v3 = _mm256_setr_ps(row[0].v3, row[1].v3, row[2].v3, row[3].v3, col[0].v3, col[1].v3, col[2].v3, col[3].v3);
+    for (i = 0;  i < samples;  i++)
     {
-        for (i = 0;  i < 6;  i++)
-        {
-            make_goertzel_descriptor(&mf_fwd_detect_desc[i], r2_mf_fwd_frequencies[i], R2_MF_SAMPLES_PER_BLOCK);
-            make_goertzel_descriptor(&mf_back_detect_desc[i], r2_mf_back_frequencies[i], R2_MF_SAMPLES_PER_BLOCK);
-        }
-        initialised = TRUE;
+        v1 = v2;
+        v2 = v3;
+        v3 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(fac, v2), v1), _mm256_set1_ps(famp[i]));
     }
-    if (fwd)
+    _mm256_storeu_ps(out, v2);
+    for (i = 0;  i < 4;  i++)
     {
-        for (i = 0;  i < 6;  i++)
-            goertzel_init(&s->out[i], &mf_fwd_detect_desc[i]);
+        row[i].v2 = out[i];
+        col[i].v2 = out[i + 4];
     }
-    else
+    _mm256_storeu_ps(out, v3);
+    for (i = 0;  i < 4;  i++)
     {
-        for (i = 0;  i < 6;  i++)
-            goertzel_init(&s->out[i], &mf_back_detect_desc[i]);
+        row[i].v3 = out[i];
+        col[i].v3 = out[i + 4];
     }
-    s->current_digit = 0;
-    s->current_sample = 0;
-    return s;
 }
 
-static void make_goertzel_descriptor(openr2_goertzel_descriptor_t *t, float freq, int samples)
+static OR2_DSP_TARGET_AVX2 void goertzel_update_mf_dual_avx2(openr2_goertzel_state_t s[12], const int16_t amp[], const uint8_t alaw[], int samples)
 {
-    t->fac = 2.0f*cosf(2.0f*M_PI*(freq/(float) SAMPLE_RATE));
-    t->samples = samples;
-}
+    float out[12];
+    __m256 fac_lo;
+    __m128 fac_hi;
+    __m256 v1_lo;
+    __m128 v1_hi;
+    __m256 v2_lo;
+    __m128 v2_hi;
+    __m256 v3_lo;
+    __m128 v3_hi;
+    float famp;
+    int i;
 
-static openr2_goertzel_state_t *goertzel_init(openr2_goertzel_state_t *s, openr2_goertzel_descriptor_t *t)
-{
-    if (s == NULL)
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].fac;
+    fac_lo = _mm256_loadu_ps(out);
+    fac_hi = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v2;
+    v2_lo = _mm256_loadu_ps(out);
+    v2_hi = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v3;
+    v3_lo = _mm256_loadu_ps(out);
+    v3_hi = _mm_loadu_ps(out + 8);
+    for (i = 0;  i < samples;  i++)
     {
-        if ((s = (openr2_goertzel_state_t *) malloc(sizeof(*s))) == NULL)
-            return NULL;
+        famp = (float) detector_sample(amp, alaw, i);
+        v1_lo = v2_lo;
+        v2_lo = v3_lo;
+        v3_lo = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(fac_lo, v2_lo), v1_lo), _mm256_set1_ps(famp));
+        v1_hi = v2_hi;
+        v2_hi = v3_hi;
+        v3_hi = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(fac_hi, v2_hi), v1_hi), _mm_set1_ps(famp));
     }
-    s->v2 =
-    s->v3 = 0.0;
-    s->fac = t->fac;
-    s->samples = t->samples;
-    s->current_sample = 0;
-    return s;
+    _mm256_storeu_ps(out, v2_lo);
+    _mm_storeu_ps(out + 8, v2_hi);
+    for (i = 0;  i < 12;  i++)
+        s[i].v2 = out[i];
+    _mm256_storeu_ps(out, v3_lo);
+    _mm_storeu_ps(out + 8, v3_hi);
+    for (i = 0;  i < 12;  i++)
+        s[i].v3 = out[i];
 }
 
-static void goertzel_reset(openr2_goertzel_state_t *s)
+static OR2_DSP_TARGET_AVX2 void goertzel_update_mf_bank_avx2(const openr2_goertzel_value_t fac[], openr2_goertzel_value_t v2[], openr2_goertzel_value_t v3[], const openr2_goertzel_value_t amp[], int stride, int samples)
 {
-    s->v2 =
-    s->v3 = 0.0;
-    s->current_sample = 0;
+    __m256 vfac[6];
+    __m256 vv2[6];
+    __m256 vv3[6];
+    __m256 v1;
+    __m256 famp;
+    int c;
+    int i;
+    int k;
+
+    for (c = 0;  c < stride;  c += 8)
+    {
+        for (k = 0;  k < 6;  k++)
+        {
+            vfac[k] = _mm256_loadu_ps(&fac[k*stride + c]);
+            vv2[k] = _mm256_loadu_ps(&v2[k*stride + c]);
+            vv3[k] = _mm256_loadu_ps(&v3[k*stride + c]);
+        }
+        for (i = 0;  i < samples;  i++)
+        {
+            famp = _mm256_loadu_ps(&amp[i*stride + c]);
+            for (k = 0;  k < 6;  k++)
+            {
+                v1 = vv2[k];
+                vv2[k] = vv3[k];
+                vv3[k] = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(vfac[k], vv2[k]), v1), famp);
+            }
+        }
+        for (k = 0;  k < 6;  k++)
+        {
+            _mm256_storeu_ps(&v2[k*stride + c], vv2[k]);
+            _mm256_storeu_ps(&v3[k*stride + c], vv3[k]);
+        }
+    }
 }
+#endif
 
-static float goertzel_result(openr2_goertzel_state_t *s)
+#if defined(OR2_DSP_NEON)
+static void goertzel_update_mf_neon(openr2_goertzel_state_t s[6], const int16_t amp[], const uint8_t alaw[], int samples)
 {
-    float v1;
-    /* Push a zero through the process to finish things off. */
-    v1 = s->v2;
-    s->v2 = s->v3;
-    s->v3 = s->fac*s->v2 - v1;
-    /* Now calculate the non-recursive side of the filter. */
-    /* The result here is not scaled down to allow for the magnification
-       effect of the filter (the usual DFT magnification effect). */
-    return s->v3*s->v3 + s->v2*s->v2 - s->v2*s->v3*s->fac;
+    float out[8];
+    float32x4_t fac_lo;
+    float32x4_t fac_hi;
+    float32x4_t v1;
+    float32x4_t v2_lo;
+    float32x4_t v2_hi;
+    float32x4_t v3_lo;
+    float32x4_t v3_hi;
+    float32x4_t famp;
+    int i;
+
+    out[6] =
+    out[7] = 0.0f;
+    for (i = 0;  i < 6;  i++)
+        out[i] = s[i].fac;
+    fac_lo = vld1q_f32(out);
+    fac_hi = vld1q_f32(out + 4);
+    for (i = 0;  i < 6;  i++)
+        out[i] = s[i].v2;
+    v2_lo = vld1q_f32(out);
+    v2_hi = vld1q_f32(out + 4);
+    for (i = 0;  i < 6;  i++)
+        out[i] = s[i].v3;
+    v3_lo = vld1q_f32(out);
+    v3_hi = vld1q_f32(out + 4);
+    for (i = 0;  i < samples;  i++)
+    {
+        famp = vdupq_n_f32((float) detector_sample(amp, alaw, i));
+        v1 = v2_lo;
+        v2_lo = v3_lo;
+        v3_lo = vaddq_f32(vsubq_f32(vmulq_f32(fac_lo, v2_lo), v1), famp);
+        v1 = v2_hi;
+        v2_hi = v3_hi;
+        v3_hi = vaddq_f32(vsubq_f32(vmulq_f32(fac_hi, v2_hi), v1), famp);
+    }
+    vst1q_f32(out, v2_lo);
+    vst1q_f32(out + 4, v2_hi);
+    for (i = 0;  i < 6;  i++)
+        s[i].v2 = out[i];
+    vst1q_f32(out, v3_lo);
+    vst1q_f32(out + 4, v3_hi);
+    for (i = 0;  i < 6;  i++)
+        s[i].v3 = out[i];
 }
 
-static void make_tone_gen_descriptor(openr2_tone_gen_descriptor_t *s,
-                              int f1,
-                              int l1,
-                              int f2,
-                              int l2,
-                              int d1,
-                              int d2,
-                              int d3,
-                              int d4,
-                              int repeat)
+static void goertzel_update_dtmf_neon(openr2_goertzel_state_t row[4], openr2_goertzel_state_t col[4], const openr2_goertzel_value_t famp[], int samples)
 {
-    memset(s, 0, sizeof(*s));
-    if (f1)
+    float out[4];
+    float32x4_t row_fac;
+    float32x4_t col_fac;
+    float32x4_t v1;
+    float32x4_t row_v2;
+    float32x4_t row_v3;
+    float32x4_t col_v2;
+    float32x4_t col_v3;
+    float32x4_t x;
+    int i;
+
+    for (i = 0;  i < 4;  i++)
+        out[i] = row[i].fac;
+    row_fac = vld1q_f32(out);
+    for (i = 0;  i < 4;  i++)
+        out[i] = col[i].fac;
+    col_fac = vld1q_f32(out);
+    for (i = 0;  i < 4;  i++)
+        out[i] = row[i].v2;
+    row_v2 = vld1q_f32(out);
+    for (i = 0;  i < 4;  i++)
+        out[i] = row[i].v3;
+    row_v3 = vld1q_f32(out);
+    for (i = 0;  i < 4;  i++)
+        out[i] = col[i].v2;
+    col_v2 = vld1q_f32(out);
+    for (i = 0;  i < 4;  i++)
+        out[i] = col[i].v3;
+    col_v3 = vld1q_f32(out);
+    for (i = 0;  i < samples;  i++)
     {
-        s->tone[0].phase_rate = dds_phase_ratef((float) f1);
-        if (f2 < 0)
-            s->tone[0].phase_rate = -s->tone[0].phase_rate;
-        s->tone[0].gain = dds_scaling_dbm0f((float) l1);
+        x = vdupq_n_f32(famp[i]);
+        v1 = row_v2;
+        row_v2 = row_v3;
+        row_v3 = vaddq_f32(vsubq_f32(vmulq_f32(row_fac, row_v2), v1), x);
+        v1 = col_v2;
+        col_v2 = col_v3;
+        col_v3 = vaddq_f32(vsubq_f32(vmulq_f32(col_fac, col_v2), v1), x);
     }
-    if (f2)
+    vst1q_f32(out, row_v2);
+    for (i = 0;  i < 4;  i++)
+        row[i].v2 = out[i];
+    vst1q_f32(out, row_v3);
+    for (i = 0;  i < 4;  i++)
+        row[i].v3 = out[i];
+    vst1q_f32(out, col_v2);
+    for (i = 0;  i < 4;  i++)
+        col[i].v2 = out[i];
+    vst1q_f32(out, col_v3);
+    for (i = 0;  i < 4;  i++)
+        col[i].v3 = out[i];
+}
+
+static void goertzel_update_mf_dual_neon(openr2_goertzel_state_t s[12], const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    float out[12];
+    float32x4_t fac_a;
+    float32x4_t fac_b;
+    float32x4_t fac_c;
+    float32x4_t v1;
+    float32x4_t v2_a;
+    float32x4_t v2_b;
+    float32x4_t v2_c;
+    float32x4_t v3_a;
+    float32x4_t v3_b;
+    float32x4_t v3_c;
+    float32x4_t famp;
+    int i;
+
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].fac;
+    fac_a = vld1q_f32(out);
+    fac_b = vld1q_f32(out + 4);
+    fac_c = vld1q_f32(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v2;
+    v2_a = vld1q_f32(out);
+    v2_b = vld1q_f32(out + 4);
+    v2_c = vld1q_f32(out + 8);
+    for (i = 0;  i < 12;  i++)
+        out[i] = s[i].v3;
+    v3_a = vld1q_f32(out);
+    v3_b = vld1q_f32(out + 4);
+    v3_c = vld1q_f32(out + 8);
+    for (i = 0;  i < samples;  i++)
     {
-        s->tone[1].phase_rate = dds_phase_ratef((float) abs(f2));
-        s->tone[1].gain = (f2 < 0)  ?  (float) l2/100.0f  :  dds_scaling_dbm0f((float) l2);
+        famp = vdupq_n_f32((float) detector_sample(amp, alaw, i));
+        v1 = v2_a;
+        v2_a = v3_a;
+        v3_a = vaddq_f32(vsubq_f32(vmulq_f32(fac_a, v2_a), v1), famp);
+        v1 = v2_b;
+        v2_b = v3_b;
+        v3_b = vaddq_f32(vsubq_f32(vmulq_f32(fac_b, v2_b), v1), famp);
+        v1 = v2_c;
+        v2_c = v3_c;
+        v3_c = vaddq_f32(vsubq_f32(vmulq_f32(fac_c, v2_c), v1), famp);
     }
+    vst1q_f32(out, v2_a);
+    vst1q_f32(out + 4, v2_b);
+    vst1q_f32(out + 8, v2_c);
+    for (i = 0;  i < 12;  i++)
+        s[i].v2 = out[i];
+    vst1q_f32(out, v3_a);
+    vst1q_f32(out + 4, v3_b);
+    vst1q_f32(out + 8, v3_c);
+    for (i = 0;  i < 12;  i++)
+        s[i].v3 = out[i];
+}
 
-    s->duration[0] = d1*SAMPLE_RATE/1000;
-    s->duration[1] = d2*SAMPLE_RATE/1000;
-    s->duration[2] = d3*SAMPLE_RATE/1000;
-    s->duration[3] = d4*SAMPLE_RATE/1000;
+static void goertzel_update_mf_bank_neon(const openr2_goertzel_value_t fac[], openr2_goertzel_value_t v2[], openr2_goertzel_value_t v3[], const openr2_goertzel_value_t amp[], int stride, int samples)
+{
+    float32x4_t vfac[6];
+    float32x4_t vv2[6];
+    float32x4_t vv3[6];
+    float32x4_t v1;
+    float32x4_t famp;
+    int c;
+    int i;
+    int k;
 
-    s->repeat = repeat;
+    for (c = 0;  c < stride;  c += 4)
+    {
+        for (k = 0;  k < 6;  k++)
+        {
+            vfac[k] = vld1q_f32(&fac[k*stride + c]);
+            vv2[k] = vld1q_f32(&v2[k*stride + c]);
+            vv3[k] = vld1q_f32(&v3[k*stride + c]);
+        }
+        for (i = 0;  i < samples;  i++)
+        {
+            famp = vld1q_f32(&amp[i*stride + c]);
+            for (k = 0;  k < 6;  k++)
+            {
+                v1 = vv2[k];
+                vv2[k] = vv3[k];
+                vv3[k] = vaddq_f32(vsubq_f32(vmulq_f32(vfac[k], vv2[k]), v1), famp);
+            }
+        }
+        for (k = 0;  k < 6;  k++)
+        {
+            vst1q_f32(&v2[k*stride + c], vv2[k]);
+            vst1q_f32(&v3[k*stride + c], vv3[k]);
+        }
+    }
 }
+#endif
+#endif
 
-static openr2_tone_gen_state_t *tone_gen_init(openr2_tone_gen_state_t *s, openr2_tone_gen_descriptor_t *t)
+static openr2_tone_gen_state_t *tone_gen_init(openr2_tone_gen_state_t *s, const openr2_tone_gen_descriptor_t *t)
 {
     int i;
 
@@ -521,10 +1997,10 @@ static openr2_tone_gen_state_t *tone_gen_init(openr2_tone_gen_state_t *s, openr2
 
 static int tone_gen(openr2_tone_gen_state_t *s, int16_t amp[], int max_samples)
 {
+    int32_t xamp;
     int samples;
     int limit;
-    float xamp;
-    int i;
+    int tones;
 
     if (s->current_section < 0)
         return  0;
@@ -549,28 +2025,17 @@ static int tone_gen(openr2_tone_gen_state_t *s, int16_t amp[], int max_samples)
                 for (  ;  samples < limit;  samples++)
                 {
                     /* There must be two, and only two tones */
-                    xamp = dds_modf(&s->phase[0], -s->tone[0].phase_rate, s->tone[0].gain, 0)
-                         *(1.0f + dds_modf(&s->phase[1], s->tone[1].phase_rate, s->tone[1].gain, 0));
-                    amp[samples] = (int16_t) lfastrintf(xamp);
+                    xamp = dds_mod(&s->phase[0], -s->tone[0].phase_rate, s->tone[0].gain);
+                    xamp += (xamp*dds_mod(&s->phase[1], s->tone[1].phase_rate, s->tone[1].gain) + 0x4000) >> 15;
+                    amp[samples] = saturate(xamp);
                 }
             }
             else
             {
-                for (  ;  samples < limit;  samples++)
-                {
-                    xamp = 0.0f;
-                    for (i = 0;  i < 4;  i++)
-                    {
-                        if (s->tone[i].phase_rate == 0)
-                            break;
-                        xamp += dds_modf(&s->phase[i], s->tone[i].phase_rate, s->tone[i].gain, 0);
-                    }
-                    /* Saturation of the answer is the right thing at this point.
-                       However, we are normally generating well controlled tones,
-                       that cannot clip. So, the overhead of doing saturation is
-                       a waste of valuable time. */
-                    amp[samples] = (int16_t) lfastrintf(xamp);
-                }
+                for (tones = 0;  tones < 4  &&  s->tone[tones].phase_rate;  tones++)
+                    ;
+                dsp->dds_mix(&amp[samples], limit - samples, s->phase, s->tone, tones);
+                samples = limit;
             }
         }
         if (s->current_position >= s->duration[s->current_section])
@@ -595,2077 +2060,2156 @@ static int tone_gen(openr2_tone_gen_state_t *s, int16_t amp[], int max_samples)
 #define SINELEN     (1 << SLENK)
 
 /* Precreating this table allows it to be in const memory, which might
-   have some performance advantage. */
-static const float sine_table[SINELEN] =
-{
-     0.00000000f,
-     0.00306796f,
-     0.00613588f,
-     0.00920375f,
-     0.01227154f,
-     0.01533921f,
-     0.01840673f,
-     0.02147408f,
-     0.02454123f,
-     0.02760815f,
-     0.03067480f,
-     0.03374117f,
-     0.03680722f,
-     0.03987293f,
-     0.04293826f,
-     0.04600318f,
-     0.04906767f,
-     0.05213170f,
-     0.05519524f,
-     0.05825826f,
-     0.06132074f,
-     0.06438263f,
-     0.06744392f,
-     0.07050457f,
-     0.07356456f,
-     0.07662386f,
-     0.07968244f,
-     0.08274026f,
-     0.08579731f,
-     0.08885355f,
-     0.09190896f,
-     0.09496350f,
-     0.09801714f,
-     0.10106986f,
-     0.10412163f,
-     0.10717242f,
-     0.11022221f,
-     0.11327095f,
-     0.11631863f,
-     0.11936521f,
-     0.12241068f,
-     0.12545498f,
-     0.12849811f,
-     0.13154003f,
-     0.13458071f,
-     0.13762012f,
-     0.14065824f,
-     0.14369503f,
-     0.14673047f,
-     0.14976453f,
-     0.15279719f,
-     0.15582840f,
-     0.15885814f,
-     0.16188639f,
-     0.16491312f,
-     0.16793829f,
-     0.17096189f,
-     0.17398387f,
-     0.17700422f,
-     0.18002290f,
-     0.18303989f,
-     0.18605515f,
-     0.18906866f,
-     0.19208040f,
-     0.19509032f,
-     0.19809841f,
-     0.20110463f,
-     0.20410897f,
-     0.20711138f,
-     0.21011184f,
-     0.21311032f,
-     0.21610680f,
-     0.21910124f,
-     0.22209362f,
-     0.22508391f,
-     0.22807208f,
-     0.23105811f,
-     0.23404196f,
-     0.23702361f,
-     0.24000302f,
-     0.24298018f,
-     0.24595505f,
-     0.24892761f,
-     0.25189782f,
-     0.25486566f,
-     0.25783110f,
-     0.26079412f,
-     0.26375468f,
-     0.26671276f,
-     0.26966833f,
-     0.27262136f,
-     0.27557182f,
-     0.27851969f,
-     0.28146494f,
-     0.28440754f,
-     0.28734746f,
-     0.29028468f,
-     0.29321916f,
-     0.29615089f,
-     0.29907983f,
-     0.30200595f,
-     0.30492923f,
-     0.30784964f,
-     0.31076715f,
-     0.31368174f,
-     0.31659338f,
-     0.31950203f,
-     0.32240768f,
-     0.32531029f,
-     0.32820984f,
-     0.33110631f,
-     0.33399965f,
-     0.33688985f,
-     0.33977688f,
-     0.34266072f,
-     0.34554132f,
-     0.34841868f,
-     0.35129276f,
-     0.35416353f,
-     0.35703096f,
-     0.35989504f,
-     0.36275572f,
-     0.36561300f,
-     0.36846683f,
-     0.37131719f,
-     0.37416406f,
-     0.37700741f,
-     0.37984721f,
-     0.38268343f,
-     0.38551605f,
-     0.38834505f,
-     0.39117038f,
-     0.39399204f,
-     0.39680999f,
-     0.39962420f,
-     0.40243465f,
-     0.40524131f,
-     0.40804416f,
-     0.41084317f,
-     0.41363831f,
-     0.41642956f,
-     0.41921689f,
-     0.42200027f,
-     0.42477968f,
-     0.42755509f,
-     0.43032648f,
-     0.43309382f,
-     0.43585708f,
-     0.43861624f,
-     0.44137127f,
-     0.44412214f,
-     0.44686884f,
-     0.44961133f,
-     0.45234959f,
-     0.45508359f,
-     0.45781330f,
-     0.46053871f,
-     0.46325978f,
-     0.46597650f,
-     0.46868882f,
-     0.47139674f,
-     0.47410021f,
-     0.47679923f,
-     0.47949376f,
-     0.48218377f,
-     0.48486925f,
-     0.48755016f,
-     0.49022648f,
-     0.49289819f,
-     0.49556526f,
-     0.49822767f,
-     0.50088538f,
-     0.50353838f,
-     0.50618665f,
-     0.50883014f,
-     0.51146885f,
-     0.51410274f,
-     0.51673180f,
-     0.51935599f,
-     0.52197529f,
-     0.52458968f,
-     0.52719913f,
-     0.52980362f,
-     0.53240313f,
-     0.53499762f,
-     0.53758708f,
-     0.54017147f,
-     0.54275078f,
-     0.54532499f,
-     0.54789406f,
-     0.55045797f,
-     0.55301671f,
-     0.55557023f,
-     0.55811853f,
-     0.56066158f,
-     0.56319934f,
-     0.56573181f,
-     0.56825895f,
-     0.57078075f,
-     0.57329717f,
-     0.57580819f,
-     0.57831380f,
-     0.58081396f,
-     0.58330865f,
-     0.58579786f,
-     0.58828155f,
-     0.59075970f,
-     0.59323230f,
-     0.59569930f,
-     0.59816071f,
-     0.60061648f,
-     0.60306660f,
-     0.60551104f,
-     0.60794978f,
-     0.61038281f,
-     0.61281008f,
-     0.61523159f,
-     0.61764731f,
-     0.62005721f,
-     0.62246128f,
-     0.62485949f,
-     0.62725182f,
-     0.62963824f,
-     0.63201874f,
-     0.63439328f,
-     0.63676186f,
-     0.63912444f,
-     0.64148101f,
-     0.64383154f,
-     0.64617601f,
-     0.64851440f,
-     0.65084668f,
-     0.65317284f,
-     0.65549285f,
-     0.65780669f,
-     0.66011434f,
-     0.66241578f,
-     0.66471098f,
-     0.66699992f,
-     0.66928259f,
-     0.67155895f,
-     0.67382900f,
-     0.67609270f,
-     0.67835004f,
-     0.68060100f,
-     0.68284555f,
-     0.68508367f,
-     0.68731534f,
-     0.68954054f,
-     0.69175926f,
-     0.69397146f,
-     0.69617713f,
-     0.69837625f,
-     0.70056879f,
-     0.70275474f,
-     0.70493408f,
-     0.70710678f,
-     0.70927283f,
-     0.71143220f,
-     0.71358487f,
-     0.71573083f,
-     0.71787005f,
-     0.72000251f,
-     0.72212819f,
-     0.72424708f,
-     0.72635916f,
-     0.72846439f,
-     0.73056277f,
-     0.73265427f,
-     0.73473888f,
-     0.73681657f,
-     0.73888732f,
-     0.74095113f,
-     0.74300795f,
-     0.74505779f,
-     0.74710061f,
-     0.74913639f,
-     0.75116513f,
-     0.75318680f,
-     0.75520138f,
-     0.75720885f,
-     0.75920919f,
-     0.76120239f,
-     0.76318842f,
-     0.76516727f,
-     0.76713891f,
-     0.76910334f,
-     0.77106052f,
-     0.77301045f,
-     0.77495311f,
-     0.77688847f,
-     0.77881651f,
-     0.78073723f,
-     0.78265060f,
-     0.78455660f,
-     0.78645521f,
-     0.78834643f,
-     0.79023022f,
-     0.79210658f,
-     0.79397548f,
-     0.79583690f,
-     0.79769084f,
-     0.79953727f,
-     0.80137617f,
-     0.80320753f,
-     0.80503133f,
-     0.80684755f,
-     0.80865618f,
-     0.81045720f,
-     0.81225059f,
-     0.81403633f,
-     0.81581441f,
-     0.81758481f,
-     0.81934752f,
-     0.82110251f,
-     0.82284978f,
-     0.82458930f,
-     0.82632106f,
-     0.82804505f,
-     0.82976123f,
-     0.83146961f,
-     0.83317016f,
-     0.83486287f,
-     0.83654773f,
-     0.83822471f,
-     0.83989379f,
-     0.84155498f,
-     0.84320824f,
-     0.84485357f,
-     0.84649094f,
-     0.84812034f,
-     0.84974177f,
-     0.85135519f,
-     0.85296060f,
-     0.85455799f,
-     0.85614733f,
-     0.85772861f,
-     0.85930182f,
-     0.86086694f,
-     0.86242396f,
-     0.86397286f,
-     0.86551362f,
-     0.86704625f,
-     0.86857071f,
-     0.87008699f,
-     0.87159509f,
-     0.87309498f,
-     0.87458665f,
-     0.87607009f,
-     0.87754529f,
-     0.87901223f,
-     0.88047089f,
-     0.88192126f,
-     0.88336334f,
-     0.88479710f,
-     0.88622253f,
-     0.88763962f,
-     0.88904836f,
-     0.89044872f,
-     0.89184071f,
-     0.89322430f,
-     0.89459949f,
-     0.89596625f,
-     0.89732458f,
-     0.89867447f,
-     0.90001589f,
-     0.90134885f,
-     0.90267332f,
-     0.90398929f,
-     0.90529676f,
-     0.90659570f,
-     0.90788612f,
-     0.90916798f,
-     0.91044129f,
-     0.91170603f,
-     0.91296219f,
-     0.91420976f,
-     0.91544872f,
-     0.91667906f,
-     0.91790078f,
-     0.91911385f,
-     0.92031828f,
-     0.92151404f,
-     0.92270113f,
-     0.92387953f,
-     0.92504924f,
-     0.92621024f,
-     0.92736253f,
-     0.92850608f,
-     0.92964090f,
-     0.93076696f,
-     0.93188427f,
-     0.93299280f,
-     0.93409255f,
-     0.93518351f,
-     0.93626567f,
-     0.93733901f,
-     0.93840353f,
-     0.93945922f,
-     0.94050607f,
-     0.94154407f,
-     0.94257320f,
-     0.94359346f,
-     0.94460484f,
-     0.94560733f,
-     0.94660091f,
-     0.94758559f,
-     0.94856135f,
-     0.94952818f,
-     0.95048607f,
-     0.95143502f,
-     0.95237501f,
-     0.95330604f,
-     0.95422810f,
-     0.95514117f,
-     0.95604525f,
-     0.95694034f,
-     0.95782641f,
-     0.95870347f,
-     0.95957151f,
-     0.96043052f,
-     0.96128049f,
-     0.96212140f,
-     0.96295327f,
-     0.96377607f,
-     0.96458979f,
-     0.96539444f,
-     0.96619000f,
-     0.96697647f,
-     0.96775384f,
-     0.96852209f,
-     0.96928124f,
-     0.97003125f,
-     0.97077214f,
-     0.97150389f,
-     0.97222650f,
-     0.97293995f,
-     0.97364425f,
-     0.97433938f,
-     0.97502535f,
-     0.97570213f,
-     0.97636973f,
-     0.97702814f,
-     0.97767736f,
-     0.97831737f,
-     0.97894818f,
-     0.97956977f,
-     0.98018214f,
-     0.98078528f,
-     0.98137919f,
-     0.98196387f,
-     0.98253930f,
-     0.98310549f,
-     0.98366242f,
-     0.98421009f,
-     0.98474850f,
-     0.98527764f,
-     0.98579751f,
-     0.98630810f,
-     0.98680940f,
-     0.98730142f,
-     0.98778414f,
-     0.98825757f,
-     0.98872169f,
-     0.98917651f,
-     0.98962202f,
-     0.99005821f,
-     0.99048508f,
-     0.99090264f,
-     0.99131086f,
-     0.99170975f,
-     0.99209931f,
-     0.99247953f,
-     0.99285041f,
-     0.99321195f,
-     0.99356414f,
-     0.99390697f,
-     0.99424045f,
-     0.99456457f,
-     0.99487933f,
-     0.99518473f,
-     0.99548076f,
-     0.99576741f,
-     0.99604470f,
-     0.99631261f,
-     0.99657115f,
-     0.99682030f,
-     0.99706007f,
-     0.99729046f,
-     0.99751146f,
-     0.99772307f,
-     0.99792529f,
-     0.99811811f,
-     0.99830154f,
-     0.99847558f,
-     0.99864022f,
-     0.99879546f,
-     0.99894129f,
-     0.99907773f,
-     0.99920476f,
-     0.99932238f,
-     0.99943060f,
-     0.99952942f,
-     0.99961882f,
-     0.99969882f,
-     0.99976941f,
-     0.99983058f,
-     0.99988235f,
-     0.99992470f,
-     0.99995764f,
-     0.99998118f,
-     0.99999529f,
-     1.00000000f,
-     0.99999529f,
-     0.99998118f,
-     0.99995764f,
-     0.99992470f,
-     0.99988235f,
-     0.99983058f,
-     0.99976941f,
-     0.99969882f,
-     0.99961882f,
-     0.99952942f,
-     0.99943060f,
-     0.99932238f,
-     0.99920476f,
-     0.99907773f,
-     0.99894129f,
-     0.99879546f,
-     0.99864022f,
-     0.99847558f,
-     0.99830154f,
-     0.99811811f,
-     0.99792529f,
-     0.99772307f,
-     0.99751146f,
-     0.99729046f,
-     0.99706007f,
-     0.99682030f,
-     0.99657115f,
-     0.99631261f,
-     0.99604470f,
-     0.99576741f,
-     0.99548076f,
-     0.99518473f,
-     0.99487933f,
-     0.99456457f,
-     0.99424045f,
-     0.99390697f,
-     0.99356414f,
-     0.99321195f,
-     0.99285041f,
-     0.99247953f,
-     0.99209931f,
-     0.99170975f,
-     0.99131086f,
-     0.99090264f,
-     0.99048508f,
-     0.99005821f,
-     0.98962202f,
-     0.98917651f,
-     0.98872169f,
-     0.98825757f,
-     0.98778414f,
-     0.98730142f,
-     0.98680940f,
-     0.98630810f,
-     0.98579751f,
-     0.98527764f,
-     0.98474850f,
-     0.98421009f,
-     0.98366242f,
-     0.98310549f,
-     0.98253930f,
-     0.98196387f,
-     0.98137919f,
-     0.98078528f,
-     0.98018214f,
-     0.97956977f,
-     0.97894818f,
-     0.97831737f,
-     0.97767736f,
-     0.97702814f,
-     0.97636973f,
-     0.97570213f,
-     0.97502535f,
-     0.97433938f,
-     0.97364425f,
-     0.97293995f,
-     0.97222650f,
-     0.97150389f,
-     0.97077214f,
-     0.97003125f,
-     0.96928124f,
-     0.96852209f,
-     0.96775384f,
-     0.96697647f,
-     0.96619000f,
-     0.96539444f,
-     0.96458979f,
-     0.96377607f,
-     0.96295327f,
-     0.96212140f,
-     0.96128049f,
-     0.96043052f,
-     0.95957151f,
-     0.95870347f,
-     0.95782641f,
-     0.95694034f,
-     0.95604525f,
-     0.95514117f,
-     0.95422810f,
-     0.95330604f,
-     0.95237501f,
-     0.95143502f,
-     0.95048607f,
-     0.94952818f,
-     0.94856135f,
-     0.94758559f,
-     0.94660091f,
-     0.94560733f,
-     0.94460484f,
-     0.94359346f,
-     0.94257320f,
-     0.94154407f,
-     0.94050607f,
-     0.93945922f,
-     0.93840353f,
-     0.93733901f,
-     0.93626567f,
-     0.93518351f,
-     0.93409255f,
-     0.93299280f,
-     0.93188427f,
-     0.93076696f,
-     0.92964090f,
-     0.92850608f,
-     0.92736253f,
-     0.92621024f,
-     0.92504924f,
-     0.92387953f,
-     0.92270113f,
-     0.92151404f,
-     0.92031828f,
-     0.91911385f,
-     0.91790078f,
-     0.91667906f,
-     0.91544872f,
-     0.91420976f,
-     0.91296219f,
-     0.91170603f,
-     0.91044129f,
-     0.90916798f,
-     0.90788612f,
-     0.90659570f,
-     0.90529676f,
-     0.90398929f,
-     0.90267332f,
-     0.90134885f,
-     0.90001589f,
-     0.89867447f,
-     0.89732458f,
-     0.89596625f,
-     0.89459949f,
-     0.89322430f,
-     0.89184071f,
-     0.89044872f,
-     0.88904836f,
-     0.88763962f,
-     0.88622253f,
-     0.88479710f,
-     0.88336334f,
-     0.88192126f,
-     0.88047089f,
-     0.87901223f,
-     0.87754529f,
-     0.87607009f,
-     0.87458665f,
-     0.87309498f,
-     0.87159509f,
-     0.87008699f,
-     0.86857071f,
-     0.86704625f,
-     0.86551362f,
-     0.86397286f,
-     0.86242396f,
-     0.86086694f,
-     0.85930182f,
-     0.85772861f,
-     0.85614733f,
-     0.85455799f,
-     0.85296060f,
-     0.85135519f,
-     0.84974177f,
-     0.84812034f,
-     0.84649094f,
-     0.84485357f,
-     0.84320824f,
-     0.84155498f,
-     0.83989379f,
-     0.83822471f,
-     0.83654773f,
-     0.83486287f,
-     0.83317016f,
-     0.83146961f,
-     0.82976123f,
-     0.82804505f,
-     0.82632106f,
-     0.82458930f,
-     0.82284978f,
-     0.82110251f,
-     0.81934752f,
-     0.81758481f,
-     0.81581441f,
-     0.81403633f,
-     0.81225059f,
-     0.81045720f,
-     0.80865618f,
-     0.80684755f,
-     0.80503133f,
-     0.80320753f,
-     0.80137617f,
-     0.79953727f,
-     0.79769084f,
-     0.79583690f,
-     0.79397548f,
-     0.79210658f,
-     0.79023022f,
-     0.78834643f,
-     0.78645521f,
-     0.78455660f,
-     0.78265060f,
-     0.78073723f,
-     0.77881651f,
-     0.77688847f,
-     0.77495311f,
-     0.77301045f,
-     0.77106052f,
-     0.76910334f,
-     0.76713891f,
-     0.76516727f,
-     0.76318842f,
-     0.76120239f,
-     0.75920919f,
-     0.75720885f,
-     0.75520138f,
-     0.75318680f,
-     0.75116513f,
-     0.74913639f,
-     0.74710061f,
-     0.74505779f,
-     0.74300795f,
-     0.74095113f,
-     0.73888732f,
-     0.73681657f,
-     0.73473888f,
-     0.73265427f,
-     0.73056277f,
-     0.72846439f,
-     0.72635916f,
-     0.72424708f,
-     0.72212819f,
-     0.72000251f,
-     0.71787005f,
-     0.71573083f,
-     0.71358487f,
-     0.71143220f,
-     0.70927283f,
-     0.70710678f,
-     0.70493408f,
-     0.70275474f,
-     0.70056879f,
-     0.69837625f,
-     0.69617713f,
-     0.69397146f,
-     0.69175926f,
-     0.68954054f,
-     0.68731534f,
-     0.68508367f,
-     0.68284555f,
-     0.68060100f,
-     0.67835004f,
-     0.67609270f,
-     0.67382900f,
-     0.67155895f,
-     0.66928259f,
-     0.66699992f,
-     0.66471098f,
-     0.66241578f,
-     0.66011434f,
-     0.65780669f,
-     0.65549285f,
-     0.65317284f,
-     0.65084668f,
-     0.64851440f,
-     0.64617601f,
-     0.64383154f,
-     0.64148101f,
-     0.63912444f,
-     0.63676186f,
-     0.63439328f,
-     0.63201874f,
-     0.62963824f,
-     0.62725182f,
-     0.62485949f,
-     0.62246128f,
-     0.62005721f,
-     0.61764731f,
-     0.61523159f,
-     0.61281008f,
-     0.61038281f,
-     0.60794978f,
-     0.60551104f,
-     0.60306660f,
-     0.60061648f,
-     0.59816071f,
-     0.59569930f,
-     0.59323230f,
-     0.59075970f,
-     0.58828155f,
-     0.58579786f,
-     0.58330865f,
-     0.58081396f,
-     0.57831380f,
-     0.57580819f,
-     0.57329717f,
-     0.57078075f,
-     0.56825895f,
-     0.56573181f,
-     0.56319934f,
-     0.56066158f,
-     0.55811853f,
-     0.55557023f,
-     0.55301671f,
-     0.55045797f,
-     0.54789406f,
-     0.54532499f,
-     0.54275078f,
-     0.54017147f,
-     0.53758708f,
-     0.53499762f,
-     0.53240313f,
-     0.52980362f,
-     0.52719913f,
-     0.52458968f,
-     0.52197529f,
-     0.51935599f,
-     0.51673180f,
-     0.51410274f,
-     0.51146885f,
-     0.50883014f,
-     0.50618665f,
-     0.50353838f,
-     0.50088538f,
-     0.49822767f,
-     0.49556526f,
-     0.49289819f,
-     0.49022648f,
-     0.48755016f,
-     0.48486925f,
-     0.48218377f,
-     0.47949376f,
-     0.47679923f,
-     0.47410021f,
-     0.47139674f,
-     0.46868882f,
-     0.46597650f,
-     0.46325978f,
-     0.46053871f,
-     0.45781330f,
-     0.45508359f,
-     0.45234959f,
-     0.44961133f,
-     0.44686884f,
-     0.44412214f,
-     0.44137127f,
-     0.43861624f,
-     0.43585708f,
-     0.43309382f,
-     0.43032648f,
-     0.42755509f,
-     0.42477968f,
-     0.42200027f,
-     0.41921689f,
-     0.41642956f,
-     0.41363831f,
-     0.41084317f,
-     0.40804416f,
-     0.40524131f,
-     0.40243465f,
-     0.39962420f,
-     0.39680999f,
-     0.39399204f,
-     0.39117038f,
-     0.38834505f,
-     0.38551605f,
-     0.38268343f,
-     0.37984721f,
-     0.37700741f,
-     0.37416406f,
-     0.37131719f,
-     0.36846683f,
-     0.36561300f,
-     0.36275572f,
-     0.35989504f,
-     0.35703096f,
-     0.35416353f,
-     0.35129276f,
-     0.34841868f,
-     0.34554132f,
-     0.34266072f,
-     0.33977688f,
-     0.33688985f,
-     0.33399965f,
-     0.33110631f,
-     0.32820984f,
-     0.32531029f,
-     0.32240768f,
-     0.31950203f,
-     0.31659338f,
-     0.31368174f,
-     0.31076715f,
-     0.30784964f,
-     0.30492923f,
-     0.30200595f,
-     0.29907983f,
-     0.29615089f,
-     0.29321916f,
-     0.29028468f,
-     0.28734746f,
-     0.28440754f,
-     0.28146494f,
-     0.27851969f,
-     0.27557182f,
-     0.27262136f,
-     0.26966833f,
-     0.26671276f,
-     0.26375468f,
-     0.26079412f,
-     0.25783110f,
-     0.25486566f,
-     0.25189782f,
-     0.24892761f,
-     0.24595505f,
-     0.24298018f,
-     0.24000302f,
-     0.23702361f,
-     0.23404196f,
-     0.23105811f,
-     0.22807208f,
-     0.22508391f,
-     0.22209362f,
-     0.21910124f,
-     0.21610680f,
-     0.21311032f,
-     0.21011184f,
-     0.20711138f,
-     0.20410897f,
-     0.20110463f,
-     0.19809841f,
-     0.19509032f,
-     0.19208040f,
-     0.18906866f,
-     0.18605515f,
-     0.18303989f,
-     0.18002290f,
-     0.17700422f,
-     0.17398387f,
-     0.17096189f,
-     0.16793829f,
-     0.16491312f,
-     0.16188639f,
-     0.15885814f,
-     0.15582840f,
-     0.15279719f,
-     0.14976453f,
-     0.14673047f,
-     0.14369503f,
-     0.14065824f,
-     0.13762012f,
-     0.13458071f,
-     0.13154003f,
-     0.12849811f,
-     0.12545498f,
-     0.12241068f,
-     0.11936521f,
-     0.11631863f,
-     0.11327095f,
-     0.11022221f,
-     0.10717242f,
-     0.10412163f,
-     0.10106986f,
-     0.09801714f,
-     0.09496350f,
-     0.09190896f,
-     0.08885355f,
-     0.08579731f,
-     0.08274026f,
-     0.07968244f,
-     0.07662386f,
-     0.07356456f,
-     0.07050457f,
-     0.06744392f,
-     0.06438263f,
-     0.06132074f,
-     0.05825826f,
-     0.05519524f,
-     0.05213170f,
-     0.04906767f,
-     0.04600318f,
-     0.04293826f,
-     0.03987293f,
-     0.03680722f,
-     0.03374117f,
-     0.03067480f,
-     0.02760815f,
-     0.02454123f,
-     0.02147408f,
-     0.01840673f,
-     0.01533921f,
-     0.01227154f,
-     0.00920375f,
-     0.00613588f,
-     0.00306796f,
-     0.00000000f,
-    -0.00306796f,
-    -0.00613588f,
-    -0.00920375f,
-    -0.01227154f,
-    -0.01533921f,
-    -0.01840673f,
-    -0.02147408f,
-    -0.02454123f,
-    -0.02760815f,
-    -0.03067480f,
-    -0.03374117f,
-    -0.03680722f,
-    -0.03987293f,
-    -0.04293826f,
-    -0.04600318f,
-    -0.04906767f,
-    -0.05213170f,
-    -0.05519524f,
-    -0.05825826f,
-    -0.06132074f,
-    -0.06438263f,
-    -0.06744392f,
-    -0.07050457f,
-    -0.07356456f,
-    -0.07662386f,
-    -0.07968244f,
-    -0.08274026f,
-    -0.08579731f,
-    -0.08885355f,
-    -0.09190896f,
-    -0.09496350f,
-    -0.09801714f,
-    -0.10106986f,
-    -0.10412163f,
-    -0.10717242f,
-    -0.11022221f,
-    -0.11327095f,
-    -0.11631863f,
-    -0.11936521f,
-    -0.12241068f,
-    -0.12545498f,
-    -0.12849811f,
-    -0.13154003f,
-    -0.13458071f,
-    -0.13762012f,
-    -0.14065824f,
-    -0.14369503f,
-    -0.14673047f,
-    -0.14976453f,
-    -0.15279719f,
-    -0.15582840f,
-    -0.15885814f,
-    -0.16188639f,
-    -0.16491312f,
-    -0.16793829f,
-    -0.17096189f,
-    -0.17398387f,
-    -0.17700422f,
-    -0.18002290f,
-    -0.18303989f,
-    -0.18605515f,
-    -0.18906866f,
-    -0.19208040f,
-    -0.19509032f,
-    -0.19809841f,
-    -0.20110463f,
-    -0.20410897f,
-    -0.20711138f,
-    -0.21011184f,
-    -0.21311032f,
-    -0.21610680f,
-    -0.21910124f,
-    -0.22209362f,
-    -0.22508391f,
-    -0.22807208f,
-    -0.23105811f,
-    -0.23404196f,
-    -0.23702361f,
-    -0.24000302f,
-    -0.24298018f,
-    -0.24595505f,
-    -0.24892761f,
-    -0.25189782f,
-    -0.25486566f,
-    -0.25783110f,
-    -0.26079412f,
-    -0.26375468f,
-    -0.26671276f,
-    -0.26966833f,
-    -0.27262136f,
-    -0.27557182f,
-    -0.27851969f,
-    -0.28146494f,
-    -0.28440754f,
-    -0.28734746f,
-    -0.29028468f,
-    -0.29321916f,
-    -0.29615089f,
-    -0.29907983f,
-    -0.30200595f,
-    -0.30492923f,
-    -0.30784964f,
-    -0.31076715f,
-    -0.31368174f,
-    -0.31659338f,
-    -0.31950203f,
-    -0.32240768f,
-    -0.32531029f,
-    -0.32820984f,
-    -0.33110631f,
-    -0.33399965f,
-    -0.33688985f,
-    -0.33977688f,
-    -0.34266072f,
-    -0.34554132f,
-    -0.34841868f,
-    -0.35129276f,
-    -0.35416353f,
-    -0.35703096f,
-    -0.35989504f,
-    -0.36275572f,
-    -0.36561300f,
-    -0.36846683f,
-    -0.37131719f,
-    -0.37416406f,
-    -0.37700741f,
-    -0.37984721f,
-    -0.38268343f,
-    -0.38551605f,
-    -0.38834505f,
-    -0.39117038f,
-    -0.39399204f,
-    -0.39680999f,
-    -0.39962420f,
-    -0.40243465f,
-    -0.40524131f,
-    -0.40804416f,
-    -0.41084317f,
-    -0.41363831f,
-    -0.41642956f,
-    -0.41921689f,
-    -0.42200027f,
-    -0.42477968f,
-    -0.42755509f,
-    -0.43032648f,
-    -0.43309382f,
-    -0.43585708f,
-    -0.43861624f,
-    -0.44137127f,
-    -0.44412214f,
-    -0.44686884f,
-    -0.44961133f,
-    -0.45234959f,
-    -0.45508359f,
-    -0.45781330f,
-    -0.46053871f,
-    -0.46325978f,
-    -0.46597650f,
-    -0.46868882f,
-    -0.47139674f,
-    -0.47410021f,
-    -0.47679923f,
-    -0.47949376f,
-    -0.48218377f,
-    -0.48486925f,
-    -0.48755016f,
-    -0.49022648f,
-    -0.49289819f,
-    -0.49556526f,
-    -0.49822767f,
-    -0.50088538f,
-    -0.50353838f,
-    -0.50618665f,
-    -0.50883014f,
-    -0.51146885f,
-    -0.51410274f,
-    -0.51673180f,
-    -0.51935599f,
-    -0.52197529f,
-    -0.52458968f,
-    -0.52719913f,
-    -0.52980362f,
-    -0.53240313f,
-    -0.53499762f,
-    -0.53758708f,
-    -0.54017147f,
-    -0.54275078f,
-    -0.54532499f,
-    -0.54789406f,
-    -0.55045797f,
-    -0.55301671f,
-    -0.55557023f,
-    -0.55811853f,
-    -0.56066158f,
-    -0.56319934f,
-    -0.56573181f,
-    -0.56825895f,
-    -0.57078075f,
-    -0.57329717f,
-    -0.57580819f,
-    -0.57831380f,
-    -0.58081396f,
-    -0.58330865f,
-    -0.58579786f,
-    -0.58828155f,
-    -0.59075970f,
-    -0.59323230f,
-    -0.59569930f,
-    -0.59816071f,
-    -0.60061648f,
-    -0.60306660f,
-    -0.60551104f,
-    -0.60794978f,
-    -0.61038281f,
-    -0.61281008f,
-    -0.61523159f,
-    -0.61764731f,
-    -0.62005721f,
-    -0.62246128f,
-    -0.62485949f,
-    -0.62725182f,
-    -0.62963824f,
-    -0.63201874f,
-    -0.63439328f,
-    -0.63676186f,
-    -0.63912444f,
-    -0.64148101f,
-    -0.64383154f,
-    -0.64617601f,
-    -0.64851440f,
-    -0.65084668f,
-    -0.65317284f,
-    -0.65549285f,
-    -0.65780669f,
-    -0.66011434f,
-    -0.66241578f,
-    -0.66471098f,
-    -0.66699992f,
-    -0.66928259f,
-    -0.67155895f,
-    -0.67382900f,
-    -0.67609270f,
-    -0.67835004f,
-    -0.68060100f,
-    -0.68284555f,
-    -0.68508367f,
-    -0.68731534f,
-    -0.68954054f,
-    -0.69175926f,
-    -0.69397146f,
-    -0.69617713f,
-    -0.69837625f,
-    -0.70056879f,
-    -0.70275474f,
-    -0.70493408f,
-    -0.70710678f,
-    -0.70927283f,
-    -0.71143220f,
-    -0.71358487f,
-    -0.71573083f,
-    -0.71787005f,
-    -0.72000251f,
-    -0.72212819f,
-    -0.72424708f,
-    -0.72635916f,
-    -0.72846439f,
-    -0.73056277f,
-    -0.73265427f,
-    -0.73473888f,
-    -0.73681657f,
-    -0.73888732f,
-    -0.74095113f,
-    -0.74300795f,
-    -0.74505779f,
-    -0.74710061f,
-    -0.74913639f,
-    -0.75116513f,
-    -0.75318680f,
-    -0.75520138f,
-    -0.75720885f,
-    -0.75920919f,
-    -0.76120239f,
-    -0.76318842f,
-    -0.76516727f,
-    -0.76713891f,
-    -0.76910334f,
-    -0.77106052f,
-    -0.77301045f,
-    -0.77495311f,
-    -0.77688847f,
-    -0.77881651f,
-    -0.78073723f,
-    -0.78265060f,
-    -0.78455660f,
-    -0.78645521f,
-    -0.78834643f,
-    -0.79023022f,
-    -0.79210658f,
-    -0.79397548f,
-    -0.79583690f,
-    -0.79769084f,
-    -0.79953727f,
-    -0.80137617f,
-    -0.80320753f,
-    -0.80503133f,
-    -0.80684755f,
-    -0.80865618f,
-    -0.81045720f,
-    -0.81225059f,
-    -0.81403633f,
-    -0.81581441f,
-    -0.81758481f,
-    -0.81934752f,
-    -0.82110251f,
-    -0.82284978f,
-    -0.82458930f,
-    -0.82632106f,
-    -0.82804505f,
-    -0.82976123f,
-    -0.83146961f,
-    -0.83317016f,
-    -0.83486287f,
-    -0.83654773f,
-    -0.83822471f,
-    -0.83989379f,
-    -0.84155498f,
-    -0.84320824f,
-    -0.84485357f,
-    -0.84649094f,
-    -0.84812034f,
-    -0.84974177f,
-    -0.85135519f,
-    -0.85296060f,
-    -0.85455799f,
-    -0.85614733f,
-    -0.85772861f,
-    -0.85930182f,
-    -0.86086694f,
-    -0.86242396f,
-    -0.86397286f,
-    -0.86551362f,
-    -0.86704625f,
-    -0.86857071f,
-    -0.87008699f,
-    -0.87159509f,
-    -0.87309498f,
-    -0.87458665f,
-    -0.87607009f,
-    -0.87754529f,
-    -0.87901223f,
-    -0.88047089f,
-    -0.88192126f,
-    -0.88336334f,
-    -0.88479710f,
-    -0.88622253f,
-    -0.88763962f,
-    -0.88904836f,
-    -0.89044872f,
-    -0.89184071f,
-    -0.89322430f,
-    -0.89459949f,
-    -0.89596625f,
-    -0.89732458f,
-    -0.89867447f,
-    -0.90001589f,
-    -0.90134885f,
-    -0.90267332f,
-    -0.90398929f,
-    -0.90529676f,
-    -0.90659570f,
-    -0.90788612f,
-    -0.90916798f,
-    -0.91044129f,
-    -0.91170603f,
-    -0.91296219f,
-    -0.91420976f,
-    -0.91544872f,
-    -0.91667906f,
-    -0.91790078f,
-    -0.91911385f,
-    -0.92031828f,
-    -0.92151404f,
-    -0.92270113f,
-    -0.92387953f,
-    -0.92504924f,
-    -0.92621024f,
-    -0.92736253f,
-    -0.92850608f,
-    -0.92964090f,
-    -0.93076696f,
-    -0.93188427f,
-    -0.93299280f,
-    -0.93409255f,
-    -0.93518351f,
-    -0.93626567f,
-    -0.93733901f,
-    -0.93840353f,
-    -0.93945922f,
-    -0.94050607f,
-    -0.94154407f,
-    -0.94257320f,
-    -0.94359346f,
-    -0.94460484f,
-    -0.94560733f,
-    -0.94660091f,
-    -0.94758559f,
-    -0.94856135f,
-    -0.94952818f,
-    -0.95048607f,
-    -0.95143502f,
-    -0.95237501f,
-    -0.95330604f,
-    -0.95422810f,
-    -0.95514117f,
-    -0.95604525f,
-    -0.95694034f,
-    -0.95782641f,
-    -0.95870347f,
-    -0.95957151f,
-    -0.96043052f,
-    -0.96128049f,
-    -0.96212140f,
-    -0.96295327f,
-    -0.96377607f,
-    -0.96458979f,
-    -0.96539444f,
-    -0.96619000f,
-    -0.96697647f,
-    -0.96775384f,
-    -0.96852209f,
-    -0.96928124f,
-    -0.97003125f,
-    -0.97077214f,
-    -0.97150389f,
-    -0.97222650f,
-    -0.97293995f,
-    -0.97364425f,
-    -0.97433938f,
-    -0.97502535f,
-    -0.97570213f,
-    -0.97636973f,
-    -0.97702814f,
-    -0.97767736f,
-    -0.97831737f,
-    -0.97894818f,
-    -0.97956977f,
-    -0.98018214f,
-    -0.98078528f,
-    -0.98137919f,
-    -0.98196387f,
-    -0.98253930f,
-    -0.98310549f,
-    -0.98366242f,
-    -0.98421009f,
-    -0.98474850f,
-    -0.98527764f,
-    -0.98579751f,
-    -0.98630810f,
-    -0.98680940f,
-    -0.98730142f,
-    -0.98778414f,
-    -0.98825757f,
-    -0.98872169f,
-    -0.98917651f,
-    -0.98962202f,
-    -0.99005821f,
-    -0.99048508f,
-    -0.99090264f,
-    -0.99131086f,
-    -0.99170975f,
-    -0.99209931f,
-    -0.99247953f,
-    -0.99285041f,
-    -0.99321195f,
-    -0.99356414f,
-    -0.99390697f,
-    -0.99424045f,
-    -0.99456457f,
-    -0.99487933f,
-    -0.99518473f,
-    -0.99548076f,
-    -0.99576741f,
-    -0.99604470f,
-    -0.99631261f,
-    -0.99657115f,
-    -0.99682030f,
-    -0.99706007f,
-    -0.99729046f,
-    -0.99751146f,
-    -0.99772307f,
-    -0.99792529f,
-    -0.99811811f,
-    -0.99830154f,
-    -0.99847558f,
-    -0.99864022f,
-    -0.99879546f,
-    -0.99894129f,
-    -0.99907773f,
-    -0.99920476f,
-    -0.99932238f,
-    -0.99943060f,
-    -0.99952942f,
-    -0.99961882f,
-    -0.99969882f,
-    -0.99976941f,
-    -0.99983058f,
-    -0.99988235f,
-    -0.99992470f,
-    -0.99995764f,
-    -0.99998118f,
-    -0.99999529f,
-    -1.00000000f,
-    -0.99999529f,
-    -0.99998118f,
-    -0.99995764f,
-    -0.99992470f,
-    -0.99988235f,
-    -0.99983058f,
-    -0.99976941f,
-    -0.99969882f,
-    -0.99961882f,
-    -0.99952942f,
-    -0.99943060f,
-    -0.99932238f,
-    -0.99920476f,
-    -0.99907773f,
-    -0.99894129f,
-    -0.99879546f,
-    -0.99864022f,
-    -0.99847558f,
-    -0.99830154f,
-    -0.99811811f,
-    -0.99792529f,
-    -0.99772307f,
-    -0.99751146f,
-    -0.99729046f,
-    -0.99706007f,
-    -0.99682030f,
-    -0.99657115f,
-    -0.99631261f,
-    -0.99604470f,
-    -0.99576741f,
-    -0.99548076f,
-    -0.99518473f,
-    -0.99487933f,
-    -0.99456457f,
-    -0.99424045f,
-    -0.99390697f,
-    -0.99356414f,
-    -0.99321195f,
-    -0.99285041f,
-    -0.99247953f,
-    -0.99209931f,
-    -0.99170975f,
-    -0.99131086f,
-    -0.99090264f,
-    -0.99048508f,
-    -0.99005821f,
-    -0.98962202f,
-    -0.98917651f,
-    -0.98872169f,
-    -0.98825757f,
-    -0.98778414f,
-    -0.98730142f,
-    -0.98680940f,
-    -0.98630810f,
-    -0.98579751f,
-    -0.98527764f,
-    -0.98474850f,
-    -0.98421009f,
-    -0.98366242f,
-    -0.98310549f,
-    -0.98253930f,
-    -0.98196387f,
-    -0.98137919f,
-    -0.98078528f,
-    -0.98018214f,
-    -0.97956977f,
-    -0.97894818f,
-    -0.97831737f,
-    -0.97767736f,
-    -0.97702814f,
-    -0.97636973f,
-    -0.97570213f,
-    -0.97502535f,
-    -0.97433938f,
-    -0.97364425f,
-    -0.97293995f,
-    -0.97222650f,
-    -0.97150389f,
-    -0.97077214f,
-    -0.97003125f,
-    -0.96928124f,
-    -0.96852209f,
-    -0.96775384f,
-    -0.96697647f,
-    -0.96619000f,
-    -0.96539444f,
-    -0.96458979f,
-    -0.96377607f,
-    -0.96295327f,
-    -0.96212140f,
-    -0.96128049f,
-    -0.96043052f,
-    -0.95957151f,
-    -0.95870347f,
-    -0.95782641f,
-    -0.95694034f,
-    -0.95604525f,
-    -0.95514117f,
-    -0.95422810f,
-    -0.95330604f,
-    -0.95237501f,
-    -0.95143502f,
-    -0.95048607f,
-    -0.94952818f,
-    -0.94856135f,
-    -0.94758559f,
-    -0.94660091f,
-    -0.94560733f,
-    -0.94460484f,
-    -0.94359346f,
-    -0.94257320f,
-    -0.94154407f,
-    -0.94050607f,
-    -0.93945922f,
-    -0.93840353f,
-    -0.93733901f,
-    -0.93626567f,
-    -0.93518351f,
-    -0.93409255f,
-    -0.93299280f,
-    -0.93188427f,
-    -0.93076696f,
-    -0.92964090f,
-    -0.92850608f,
-    -0.92736253f,
-    -0.92621024f,
-    -0.92504924f,
-    -0.92387953f,
-    -0.92270113f,
-    -0.92151404f,
-    -0.92031828f,
-    -0.91911385f,
-    -0.91790078f,
-    -0.91667906f,
-    -0.91544872f,
-    -0.91420976f,
-    -0.91296219f,
-    -0.91170603f,
-    -0.91044129f,
-    -0.90916798f,
-    -0.90788612f,
-    -0.90659570f,
-    -0.90529676f,
-    -0.90398929f,
-    -0.90267332f,
-    -0.90134885f,
-    -0.90001589f,
-    -0.89867447f,
-    -0.89732458f,
-    -0.89596625f,
-    -0.89459949f,
-    -0.89322430f,
-    -0.89184071f,
-    -0.89044872f,
-    -0.88904836f,
-    -0.88763962f,
-    -0.88622253f,
-    -0.88479710f,
-    -0.88336334f,
-    -0.88192126f,
-    -0.88047089f,
-    -0.87901223f,
-    -0.87754529f,
-    -0.87607009f,
-    -0.87458665f,
-    -0.87309498f,
-    -0.87159509f,
-    -0.87008699f,
-    -0.86857071f,
-    -0.86704625f,
-    -0.86551362f,
-    -0.86397286f,
-    -0.86242396f,
-    -0.86086694f,
-    -0.85930182f,
-    -0.85772861f,
-    -0.85614733f,
-    -0.85455799f,
-    -0.85296060f,
-    -0.85135519f,
-    -0.84974177f,
-    -0.84812034f,
-    -0.84649094f,
-    -0.84485357f,
-    -0.84320824f,
-    -0.84155498f,
-    -0.83989379f,
-    -0.83822471f,
-    -0.83654773f,
-    -0.83486287f,
-    -0.83317016f,
-    -0.83146961f,
-    -0.82976123f,
-    -0.82804505f,
-    -0.82632106f,
-    -0.82458930f,
-    -0.82284978f,
-    -0.82110251f,
-    -0.81934752f,
-    -0.81758481f,
-    -0.81581441f,
-    -0.81403633f,
-    -0.81225059f,
-    -0.81045720f,
-    -0.80865618f,
-    -0.80684755f,
-    -0.80503133f,
-    -0.80320753f,
-    -0.80137617f,
-    -0.79953727f,
-    -0.79769084f,
-    -0.79583690f,
-    -0.79397548f,
-    -0.79210658f,
-    -0.79023022f,
-    -0.78834643f,
-    -0.78645521f,
-    -0.78455660f,
-    -0.78265060f,
-    -0.78073723f,
-    -0.77881651f,
-    -0.77688847f,
-    -0.77495311f,
-    -0.77301045f,
-    -0.77106052f,
-    -0.76910334f,
-    -0.76713891f,
-    -0.76516727f,
-    -0.76318842f,
-    -0.76120239f,
-    -0.75920919f,
-    -0.75720885f,
-    -0.75520138f,
-    -0.75318680f,
-    -0.75116513f,
-    -0.74913639f,
-    -0.74710061f,
-    -0.74505779f,
-    -0.74300795f,
-    -0.74095113f,
-    -0.73888732f,
-    -0.73681657f,
-    -0.73473888f,
-    -0.73265427f,
-    -0.73056277f,
-    -0.72846439f,
-    -0.72635916f,
-    -0.72424708f,
-    -0.72212819f,
-    -0.72000251f,
-    -0.71787005f,
-    -0.71573083f,
-    -0.71358487f,
-    -0.71143220f,
-    -0.70927283f,
-    -0.70710678f,
-    -0.70493408f,
-    -0.70275474f,
-    -0.70056879f,
-    -0.69837625f,
-    -0.69617713f,
-    -0.69397146f,
-    -0.69175926f,
-    -0.68954054f,
-    -0.68731534f,
-    -0.68508367f,
-    -0.68284555f,
-    -0.68060100f,
-    -0.67835004f,
-    -0.67609270f,
-    -0.67382900f,
-    -0.67155895f,
-    -0.66928259f,
-    -0.66699992f,
-    -0.66471098f,
-    -0.66241578f,
-    -0.66011434f,
-    -0.65780669f,
-    -0.65549285f,
-    -0.65317284f,
-    -0.65084668f,
-    -0.64851440f,
-    -0.64617601f,
-    -0.64383154f,
-    -0.64148101f,
-    -0.63912444f,
-    -0.63676186f,
-    -0.63439328f,
-    -0.63201874f,
-    -0.62963824f,
-    -0.62725182f,
-    -0.62485949f,
-    -0.62246128f,
-    -0.62005721f,
-    -0.61764731f,
-    -0.61523159f,
-    -0.61281008f,
-    -0.61038281f,
-    -0.60794978f,
-    -0.60551104f,
-    -0.60306660f,
-    -0.60061648f,
-    -0.59816071f,
-    -0.59569930f,
-    -0.59323230f,
-    -0.59075970f,
-    -0.58828155f,
-    -0.58579786f,
-    -0.58330865f,
-    -0.58081396f,
-    -0.57831380f,
-    -0.57580819f,
-    -0.57329717f,
-    -0.57078075f,
-    -0.56825895f,
-    -0.56573181f,
-    -0.56319934f,
-    -0.56066158f,
-    -0.55811853f,
-    -0.55557023f,
-    -0.55301671f,
-    -0.55045797f,
-    -0.54789406f,
-    -0.54532499f,
-    -0.54275078f,
-    -0.54017147f,
-    -0.53758708f,
-    -0.53499762f,
-    -0.53240313f,
-    -0.52980362f,
-    -0.52719913f,
-    -0.52458968f,
-    -0.52197529f,
-    -0.51935599f,
-    -0.51673180f,
-    -0.51410274f,
-    -0.51146885f,
-    -0.50883014f,
-    -0.50618665f,
-    -0.50353838f,
-    -0.50088538f,
-    -0.49822767f,
-    -0.49556526f,
-    -0.49289819f,
-    -0.49022648f,
-    -0.48755016f,
-    -0.48486925f,
-    -0.48218377f,
-    -0.47949376f,
-    -0.47679923f,
-    -0.47410021f,
-    -0.47139674f,
-    -0.46868882f,
-    -0.46597650f,
-    -0.46325978f,
-    -0.46053871f,
-    -0.45781330f,
-    -0.45508359f,
-    -0.45234959f,
-    -0.44961133f,
-    -0.44686884f,
-    -0.44412214f,
-    -0.44137127f,
-    -0.43861624f,
-    -0.43585708f,
-    -0.43309382f,
-    -0.43032648f,
-    -0.42755509f,
-    -0.42477968f,
-    -0.42200027f,
-    -0.41921689f,
-    -0.41642956f,
-    -0.41363831f,
-    -0.41084317f,
-    -0.40804416f,
-    -0.40524131f,
-    -0.40243465f,
-    -0.39962420f,
-    -0.39680999f,
-    -0.39399204f,
-    -0.39117038f,
-    -0.38834505f,
-    -0.38551605f,
-    -0.38268343f,
-    -0.37984721f,
-    -0.37700741f,
-    -0.37416406f,
-    -0.37131719f,
-    -0.36846683f,
-    -0.36561300f,
-    -0.36275572f,
-    -0.35989504f,
-    -0.35703096f,
-    -0.35416353f,
-    -0.35129276f,
-    -0.34841868f,
-    -0.34554132f,
-    -0.34266072f,
-    -0.33977688f,
-    -0.33688985f,
-    -0.33399965f,
-    -0.33110631f,
-    -0.32820984f,
-    -0.32531029f,
-    -0.32240768f,
-    -0.31950203f,
-    -0.31659338f,
-    -0.31368174f,
-    -0.31076715f,
-    -0.30784964f,
-    -0.30492923f,
-    -0.30200595f,
-    -0.29907983f,
-    -0.29615089f,
-    -0.29321916f,
-    -0.29028468f,
-    -0.28734746f,
-    -0.28440754f,
-    -0.28146494f,
-    -0.27851969f,
-    -0.27557182f,
-    -0.27262136f,
-    -0.26966833f,
-    -0.26671276f,
-    -0.26375468f,
-    -0.26079412f,
-    -0.25783110f,
-    -0.25486566f,
-    -0.25189782f,
-    -0.24892761f,
-    -0.24595505f,
-    -0.24298018f,
-    -0.24000302f,
-    -0.23702361f,
-    -0.23404196f,
-    -0.23105811f,
-    -0.22807208f,
-    -0.22508391f,
-    -0.22209362f,
-    -0.21910124f,
-    -0.21610680f,
-    -0.21311032f,
-    -0.21011184f,
-    -0.20711138f,
-    -0.20410897f,
-    -0.20110463f,
-    -0.19809841f,
-    -0.19509032f,
-    -0.19208040f,
-    -0.18906866f,
-    -0.18605515f,
-    -0.18303989f,
-    -0.18002290f,
-    -0.17700422f,
-    -0.17398387f,
-    -0.17096189f,
-    -0.16793829f,
-    -0.16491312f,
-    -0.16188639f,
-    -0.15885814f,
-    -0.15582840f,
-    -0.15279719f,
-    -0.14976453f,
-    -0.14673047f,
-    -0.14369503f,
-    -0.14065824f,
-    -0.13762012f,
-    -0.13458071f,
-    -0.13154003f,
-    -0.12849811f,
-    -0.12545498f,
-    -0.12241068f,
-    -0.11936521f,
-    -0.11631863f,
-    -0.11327095f,
-    -0.11022221f,
-    -0.10717242f,
-    -0.10412163f,
-    -0.10106986f,
-    -0.09801714f,
-    -0.09496350f,
-    -0.09190896f,
-    -0.08885355f,
-    -0.08579731f,
-    -0.08274026f,
-    -0.07968244f,
-    -0.07662386f,
-    -0.07356456f,
-    -0.07050457f,
-    -0.06744392f,
-    -0.06438263f,
-    -0.06132074f,
-    -0.05825826f,
-    -0.05519524f,
-    -0.05213170f,
-    -0.04906767f,
-    -0.04600318f,
-    -0.04293826f,
-    -0.03987293f,
-    -0.03680722f,
-    -0.03374117f,
-    -0.03067480f,
-    -0.02760815f,
-    -0.02454123f,
-    -0.02147408f,
-    -0.01840673f,
-    -0.01533921f,
-    -0.01227154f,
-    -0.00920375f,
-    -0.00613588f,
-    -0.00306796f
+   have some performance advantage. The values are Q15. */
+static const int16_t sine_table[SINELEN] =
+{
+         0,
+       101,
+       201,
+       302,
+       402,
+       503,
+       603,
+       704,
+       804,
+       905,
+      1005,
+      1106,
+      1206,
+      1307,
+      1407,
+      1507,
+      1608,
+      1708,
+      1809,
+      1909,
+      2009,
+      2110,
+      2210,
+      2310,
+      2410,
+      2511,
+      2611,
+      2711,
+      2811,
+      2911,
+      3012,
+      3112,
+      3212,
+      3312,
+      3412,
+      3512,
+      3612,
+      3712,
+      3811,
+      3911,
+      4011,
+      4111,
+      4210,
+      4310,
+      4410,
+      4509,
+      4609,
+      4708,
+      4808,
+      4907,
+      5007,
+      5106,
+      5205,
+      5305,
+      5404,
+      5503,
+      5602,
+      5701,
+      5800,
+      5899,
+      5998,
+      6096,
+      6195,
+      6294,
+      6393,
+      6491,
+      6590,
+      6688,
+      6786,
+      6885,
+      6983,
+      7081,
+      7179,
+      7277,
+      7375,
+      7473,
+      7571,
+      7669,
+      7767,
+      7864,
+      7962,
+      8059,
+      8157,
+      8254,
+      8351,
+      8448,
+      8545,
+      8642,
+      8739,
+      8836,
+      8933,
+      9030,
+      9126,
+      9223,
+      9319,
+      9416,
+      9512,
+      9608,
+      9704,
+      9800,
+      9896,
+      9992,
+     10087,
+     10183,
+     10278,
+     10374,
+     10469,
+     10564,
+     10659,
+     10754,
+     10849,
+     10944,
+     11039,
+     11133,
+     11228,
+     11322,
+     11417,
+     11511,
+     11605,
+     11699,
+     11793,
+     11886,
+     11980,
+     12074,
+     12167,
+     12260,
+     12353,
+     12446,
+     12539,
+     12632,
+     12725,
+     12817,
+     12910,
+     13002,
+     13094,
+     13187,
+     13279,
+     13370,
+     13462,
+     13554,
+     13645,
+     13736,
+     13828,
+     13919,
+     14010,
+     14101,
+     14191,
+     14282,
+     14372,
+     14462,
+     14553,
+     14643,
+     14732,
+     14822,
+     14912,
+     15001,
+     15090,
+     15180,
+     15269,
+     15358,
+     15446,
+     15535,
+     15623,
+     15712,
+     15800,
+     15888,
+     15976,
+     16063,
+     16151,
+     16238,
+     16325,
+     16413,
+     16499,
+     16586,
+     16673,
+     16759,
+     16846,
+     16932,
+     17018,
+     17104,
+     17189,
+     17275,
+     17360,
+     17445,
+     17530,
+     17615,
+     17700,
+     17784,
+     17869,
+     17953,
+     18037,
+     18121,
+     18204,
+     18288,
+     18371,
+     18454,
+     18537,
+     18620,
+     18703,
+     18785,
+     18868,
+     18950,
+     19032,
+     19113,
+     19195,
+     19276,
+     19357,
+     19438,
+     19519,
+     19600,
+     19680,
+     19761,
+     19841,
+     19921,
+     20000,
+     20080,
+     20159,
+     20238,
+     20317,
+     20396,
+     20475,
+     20553,
+     20631,
+     20709,
+     20787,
+     20865,
+     20942,
+     21019,
+     21096,
+     21173,
+     21250,
+     21326,
+     21403,
+     21479,
+     21554,
+     21630,
+     21705,
+     21781,
+     21856,
+     21930,
+     22005,
+     22079,
+     22154,
+     22227,
+     22301,
+     22375,
+     22448,
+     22521,
+     22594,
+     22667,
+     22739,
+     22812,
+     22884,
+     22956,
+     23027,
+     23099,
+     23170,
+     23241,
+     23311,
+     23382,
+     23452,
+     23522,
+     23592,
+     23662,
+     23731,
+     23801,
+     23870,
+     23938,
+     24007,
+     24075,
+     24143,
+     24211,
+     24279,
+     24346,
+     24413,
+     24480,
+     24547,
+     24613,
+     24680,
+     24746,
+     24811,
+     24877,
+     24942,
+     25007,
+     25072,
+     25137,
+     25201,
+     25265,
+     25329,
+     25393,
+     25456,
+     25519,
+     25582,
+     25645,
+     25708,
+     25770,
+     25832,
+     25893,
+     25955,
+     26016,
+     26077,
+     26138,
+     26198,
+     26259,
+     26319,
+     26378,
+     26438,
+     26497,
+     26556,
+     26615,
+     26674,
+     26732,
+     26790,
+     26848,
+     26905,
+     26962,
+     27019,
+     27076,
+     27133,
+     27189,
+     27245,
+     27300,
+     27356,
+     27411,
+     27466,
+     27521,
+     27575,
+     27629,
+     27683,
+     27737,
+     27790,
+     27843,
+     27896,
+     27949,
+     28001,
+     28053,
+     28105,
+     28157,
+     28208,
+     28259,
+     28310,
+     28360,
+     28411,
+     28460,
+     28510,
+     28560,
+     28609,
+     28658,
+     28706,
+     28755,
+     28803,
+     28850,
+     28898,
+     28945,
+     28992,
+     29039,
+     29085,
+     29131,
+     29177,
+     29223,
+     29268,
+     29313,
+     29358,
+     29403,
+     29447,
+     29491,
+     29534,
+     29578,
+     29621,
+     29664,
+     29706,
+     29749,
+     29791,
+     29832,
+     29874,
+     29915,
+     29956,
+     29997,
+     30037,
+     30077,
+     30117,
+     30156,
+     30195,
+     30234,
+     30273,
+     30311,
+     30349,
+     30387,
+     30424,
+     30462,
+     30498,
+     30535,
+     30571,
+     30607,
+     30643,
+     30679,
+     30714,
+     30749,
+     30783,
+     30818,
+     30852,
+     30885,
+     30919,
+     30952,
+     30985,
+     31017,
+     31050,
+     31082,
+     31113,
+     31145,
+     31176,
+     31206,
+     31237,
+     31267,
+     31297,
+     31327,
+     31356,
+     31385,
+     31414,
+     31442,
+     31470,
+     31498,
+     31526,
+     31553,
+     31580,
+     31607,
+     31633,
+     31659,
+     31685,
+     31710,
+     31736,
+     31760,
+     31785,
+     31809,
+     31833,
+     31857,
+     31880,
+     31903,
+     31926,
+     31949,
+     31971,
+     31993,
+     32014,
+     32036,
+     32057,
+     32077,
+     32098,
+     32118,
+     32137,
+     32157,
+     32176,
+     32195,
+     32213,
+     32232,
+     32250,
+     32267,
+     32285,
+     32302,
+     32318,
+     32335,
+     32351,
+     32367,
+     32382,
+     32397,
+     32412,
+     32427,
+     32441,
+     32455,
+     32469,
+     32482,
+     32495,
+     32508,
+     32521,
+     32533,
+     32545,
+     32556,
+     32567,
+     32578,
+     32589,
+     32599,
+     32609,
+     32619,
+     32628,
+     32637,
+     32646,
+     32655,
+     32663,
+     32671,
+     32678,
+     32685,
+     32692,
+     32699,
+     32705,
+     32711,
+     32717,
+     32722,
+     32728,
+     32732,
+     32737,
+     32741,
+     32745,
+     32748,
+     32752,
+     32755,
+     32757,
+     32759,
+     32761,
+     32763,
+     32765,
+     32766,
+     32766,
+     32767,
+     32767,
+     32767,
+     32766,
+     32766,
+     32765,
+     32763,
+     32761,
+     32759,
+     32757,
+     32755,
+     32752,
+     32748,
+     32745,
+     32741,
+     32737,
+     32732,
+     32728,
+     32722,
+     32717,
+     32711,
+     32705,
+     32699,
+     32692,
+     32685,
+     32678,
+     32671,
+     32663,
+     32655,
+     32646,
+     32637,
+     32628,
+     32619,
+     32609,
+     32599,
+     32589,
+     32578,
+     32567,
+     32556,
+     32545,
+     32533,
+     32521,
+     32508,
+     32495,
+     32482,
+     32469,
+     32455,
+     32441,
+     32427,
+     32412,
+     32397,
+     32382,
+     32367,
+     32351,
+     32335,
+     32318,
+     32302,
+     32285,
+     32267,
+     32250,
+     32232,
+     32213,
+     32195,
+     32176,
+     32157,
+     32137,
+     32118,
+     32098,
+     32077,
+     32057,
+     32036,
+     32014,
+     31993,
+     31971,
+     31949,
+     31926,
+     31903,
+     31880,
+     31857,
+     31833,
+     31809,
+     31785,
+     31760,
+     31736,
+     31710,
+     31685,
+     31659,
+     31633,
+     31607,
+     31580,
+     31553,
+     31526,
+     31498,
+     31470,
+     31442,
+     31414,
+     31385,
+     31356,
+     31327,
+     31297,
+     31267,
+     31237,
+     31206,
+     31176,
+     31145,
+     31113,
+     31082,
+     31050,
+     31017,
+     30985,
+     30952,
+     30919,
+     30885,
+     30852,
+     30818,
+     30783,
+     30749,
+     30714,
+     30679,
+     30643,
+     30607,
+     30571,
+     30535,
+     30498,
+     30462,
+     30424,
+     30387,
+     30349,
+     30311,
+     30273,
+     30234,
+     30195,
+     30156,
+     30117,
+     30077,
+     30037,
+     29997,
+     29956,
+     29915,
+     29874,
+     29832,
+     29791,
+     29749,
+     29706,
+     29664,
+     29621,
+     29578,
+     29534,
+     29491,
+     29447,
+     29403,
+     29358,
+     29313,
+     29268,
+     29223,
+     29177,
+     29131,
+     29085,
+     29039,
+     28992,
+     28945,
+     28898,
+     28850,
+     28803,
+     28755,
+     28706,
+     28658,
+     28609,
+     28560,
+     28510,
+     28460,
+     28411,
+     28360,
+     28310,
+     28259,
+     28208,
+     28157,
+     28105,
+     28053,
+     28001,
+     27949,
+     27896,
+     27843,
+     27790,
+     27737,
+     27683,
+     27629,
+     27575,
+     27521,
+     27466,
+     27411,
+     27356,
+     27300,
+     27245,
+     27189,
+     27133,
+     27076,
+     27019,
+     26962,
+     26905,
+     26848,
+     26790,
+     26732,
+     26674,
+     26615,
+     26556,
+     26497,
+     26438,
+     26378,
+     26319,
+     26259,
+     26198,
+     26138,
+     26077,
+     26016,
+     25955,
+     25893,
+     25832,
+     25770,
+     25708,
+     25645,
+     25582,
+     25519,
+     25456,
+     25393,
+     25329,
+     25265,
+     25201,
+     25137,
+     25072,
+     25007,
+     24942,
+     24877,
+     24811,
+     24746,
+     24680,
+     24613,
+     24547,
+     24480,
+     24413,
+     24346,
+     24279,
+     24211,
+     24143,
+     24075,
+     24007,
+     23938,
+     23870,
+     23801,
+     23731,
+     23662,
+     23592,
+     23522,
+     23452,
+     23382,
+     23311,
+     23241,
+     23170,
+     23099,
+     23027,
+     22956,
+     22884,
+     22812,
+     22739,
+     22667,
+     22594,
+     22521,
+     22448,
+     22375,
+     22301,
+     22227,
+     22154,
+     22079,
+     22005,
+     21930,
+     21856,
+     21781,
+     21705,
+     21630,
+     21554,
+     21479,
+     21403,
+     21326,
+     21250,
+     21173,
+     21096,
+     21019,
+     20942,
+     20865,
+     20787,
+     20709,
+     20631,
+     20553,
+     20475,
+     20396,
+     20317,
+     20238,
+     20159,
+     20080,
+     20000,
+     19921,
+     19841,
+     19761,
+     19680,
+     19600,
+     19519,
+     19438,
+     19357,
+     19276,
+     19195,
+     19113,
+     19032,
+     18950,
+     18868,
+     18785,
+     18703,
+     18620,
+     18537,
+     18454,
+     18371,
+     18288,
+     18204,
+     18121,
+     18037,
+     17953,
+     17869,
+     17784,
+     17700,
+     17615,
+     17530,
+     17445,
+     17360,
+     17275,
+     17189,
+     17104,
+     17018,
+     16932,
+     16846,
+     16759,
+     16673,
+     16586,
+     16499,
+     16413,
+     16325,
+     16238,
+     16151,
+     16063,
+     15976,
+     15888,
+     15800,
+     15712,
+     15623,
+     15535,
+     15446,
+     15358,
+     15269,
+     15180,
+     15090,
+     15001,
+     14912,
+     14822,
+     14732,
+     14643,
+     14553,
+     14462,
+     14372,
+     14282,
+     14191,
+     14101,
+     14010,
+     13919,
+     13828,
+     13736,
+     13645,
+     13554,
+     13462,
+     13370,
+     13279,
+     13187,
+     13094,
+     13002,
+     12910,
+     12817,
+     12725,
+     12632,
+     12539,
+     12446,
+     12353,
+     12260,
+     12167,
+     12074,
+     11980,
+     11886,
+     11793,
+     11699,
+     11605,
+     11511,
+     11417,
+     11322,
+     11228,
+     11133,
+     11039,
+     10944,
+     10849,
+     10754,
+     10659,
+     10564,
+     10469,
+     10374,
+     10278,
+     10183,
+     10087,
+      9992,
+      9896,
+      9800,
+      9704,
+      9608,
+      9512,
+      9416,
+      9319,
+      9223,
+      9126,
+      9030,
+      8933,
+      8836,
+      8739,
+      8642,
+      8545,
+      8448,
+      8351,
+      8254,
+      8157,
+      8059,
+      7962,
+      7864,
+      7767,
+      7669,
+      7571,
+      7473,
+      7375,
+      7277,
+      7179,
+      7081,
+      6983,
+      6885,
+      6786,
+      6688,
+      6590,
+      6491,
+      6393,
+      6294,
+      6195,
+      6096,
+      5998,
+      5899,
+      5800,
+      5701,
+      5602,
+      5503,
+      5404,
+      5305,
+      5205,
+      5106,
+      5007,
+      4907,
+      4808,
+      4708,
+      4609,
+      4509,
+      4410,
+      4310,
+      4210,
+      4111,
+      4011,
+      3911,
+      3811,
+      3712,
+      3612,
+      3512,
+      3412,
+      3312,
+      3212,
+      3112,
+      3012,
+      2911,
+      2811,
+      2711,
+      2611,
+      2511,
+      2410,
+      2310,
+      2210,
+      2110,
+      2009,
+      1909,
+      1809,
+      1708,
+      1608,
+      1507,
+      1407,
+      1307,
+      1206,
+      1106,
+      1005,
+       905,
+       804,
+       704,
+       603,
+       503,
+       402,
+       302,
+       201,
+       101,
+         0,
+      -101,
+      -201,
+      -302,
+      -402,
+      -503,
+      -603,
+      -704,
+      -804,
+      -905,
+     -1005,
+     -1106,
+     -1206,
+     -1307,
+     -1407,
+     -1507,
+     -1608,
+     -1708,
+     -1809,
+     -1909,
+     -2009,
+     -2110,
+     -2210,
+     -2310,
+     -2410,
+     -2511,
+     -2611,
+     -2711,
+     -2811,
+     -2911,
+     -3012,
+     -3112,
+     -3212,
+     -3312,
+     -3412,
+     -3512,
+     -3612,
+     -3712,
+     -3811,
+     -3911,
+     -4011,
+     -4111,
+     -4210,
+     -4310,
+     -4410,
+     -4509,
+     -4609,
+     -4708,
+     -4808,
+     -4907,
+     -5007,
+     -5106,
+     -5205,
+     -5305,
+     -5404,
+     -5503,
+     -5602,
+     -5701,
+     -5800,
+     -5899,
+     -5998,
+     -6096,
+     -6195,
+     -6294,
+     -6393,
+     -6491,
+     -6590,
+     -6688,
+     -6786,
+     -6885,
+     -6983,
+     -7081,
+     -7179,
+     -7277,
+     -7375,
+     -7473,
+     -7571,
+     -7669,
+     -7767,
+     -7864,
+     -7962,
+     -8059,
+     -8157,
+     -8254,
+     -8351,
+     -8448,
+     -8545,
+     -8642,
+     -8739,
+     -8836,
+     -8933,
+     -9030,
+     -9126,
+     -9223,
+     -9319,
+     -9416,
+     -9512,
+     -9608,
+     -9704,
+     -9800,
+     -9896,
+     -9992,
+    -10087,
+    -10183,
+    -10278,
+    -10374,
+    -10469,
+    -10564,
+    -10659,
+    -10754,
+    -10849,
+    -10944,
+    -11039,
+    -11133,
+    -11228,
+    -11322,
+    -11417,
+    -11511,
+    -11605,
+    -11699,
+    -11793,
+    -11886,
+    -11980,
+    -12074,
+    -12167,
+    -12260,
+    -12353,
+    -12446,
+    -12539,
+    -12632,
+    -12725,
+    -12817,
+    -12910,
+    -13002,
+    -13094,
+    -13187,
+    -13279,
+    -13370,
+    -13462,
+    -13554,
+    -13645,
+    -13736,
+    -13828,
+    -13919,
+    -14010,
+    -14101,
+    -14191,
+    -14282,
+    -14372,
+    -14462,
+    -14553,
+    -14643,
+    -14732,
+    -14822,
+    -14912,
+    -15001,
+    -15090,
+    -15180,
+    -15269,
+    -15358,
+    -15446,
+    -15535,
+    -15623,
+    -15712,
+    -15800,
+    -15888,
+    -15976,
+    -16063,
+    -16151,
+    -16238,
+    -16325,
+    -16413,
+    -16499,
+    -16586,
+    -16673,
+    -16759,
+    -16846,
+    -16932,
+    -17018,
+    -17104,
+    -17189,
+    -17275,
+    -17360,
+    -17445,
+    -17530,
+    -17615,
+    -17700,
+    -17784,
+    -17869,
+    -17953,
+    -18037,
+    -18121,
+    -18204,
+    -18288,
+    -18371,
+    -18454,
+    -18537,
+    -18620,
+    -18703,
+    -18785,
+    -18868,
+    -18950,
+    -19032,
+    -19113,
+    -19195,
+    -19276,
+    -19357,
+    -19438,
+    -19519,
+    -19600,
+    -19680,
+    -19761,
+    -19841,
+    -19921,
+    -20000,
+    -20080,
+    -20159,
+    -20238,
+    -20317,
+    -20396,
+    -20475,
+    -20553,
+    -20631,
+    -20709,
+    -20787,
+    -20865,
+    -20942,
+    -21019,
+    -21096,
+    -21173,
+    -21250,
+    -21326,
+    -21403,
+    -21479,
+    -21554,
+    -21630,
+    -21705,
+    -21781,
+    -21856,
+    -21930,
+    -22005,
+    -22079,
+    -22154,
+    -22227,
+    -22301,
+    -22375,
+    -22448,
+    -22521,
+    -22594,
+    -22667,
+    -22739,
+    -22812,
+    -22884,
+    -22956,
+    -23027,
+    -23099,
+    -23170,
+    -23241,
+    -23311,
+    -23382,
+    -23452,
+    -23522,
+    -23592,
+    -23662,
+    -23731,
+    -23801,
+    -23870,
+    -23938,
+    -24007,
+    -24075,
+    -24143,
+    -24211,
+    -24279,
+    -24346,
+    -24413,
+    -24480,
+    -24547,
+    -24613,
+    -24680,
+    -24746,
+    -24811,
+    -24877,
+    -24942,
+    -25007,
+    -25072,
+    -25137,
+    -25201,
+    -25265,
+    -25329,
+    -25393,
+    -25456,
+    -25519,
+    -25582,
+    -25645,
+    -25708,
+    -25770,
+    -25832,
+    -25893,
+    -25955,
+    -26016,
+    -26077,
+    -26138,
+    -26198,
+    -26259,
+    -26319,
+    -26378,
+    -26438,
+    -26497,
+    -26556,
+    -26615,
+    -26674,
+    -26732,
+    -26790,
+    -26848,
+    -26905,
+    -26962,
+    -27019,
+    -27076,
+    -27133,
+    -27189,
+    -27245,
+    -27300,
+    -27356,
+    -27411,
+    -27466,
+    -27521,
+    -27575,
+    -27629,
+    -27683,
+    -27737,
+    -27790,
+    -27843,
+    -27896,
+    -27949,
+    -28001,
+    -28053,
+    -28105,
+    -28157,
+    -28208,
+    -28259,
+    -28310,
+    -28360,
+    -28411,
+    -28460,
+    -28510,
+    -28560,
+    -28609,
+    -28658,
+    -28706,
+    -28755,
+    -28803,
+    -28850,
+    -28898,
+    -28945,
+    -28992,
+    -29039,
+    -29085,
+    -29131,
+    -29177,
+    -29223,
+    -29268,
+    -29313,
+    -29358,
+    -29403,
+    -29447,
+    -29491,
+    -29534,
+    -29578,
+    -29621,
+    -29664,
+    -29706,
+    -29749,
+    -29791,
+    -29832,
+    -29874,
+    -29915,
+    -29956,
+    -29997,
+    -30037,
+    -30077,
+    -30117,
+    -30156,
+    -30195,
+    -30234,
+    -30273,
+    -30311,
+    -30349,
+    -30387,
+    -30424,
+    -30462,
+    -30498,
+    -30535,
+    -30571,
+    -30607,
+    -30643,
+    -30679,
+    -30714,
+    -30749,
+    -30783,
+    -30818,
+    -30852,
+    -30885,
+    -30919,
+    -30952,
+    -30985,
+    -31017,
+    -31050,
+    -31082,
+    -31113,
+    -31145,
+    -31176,
+    -31206,
+    -31237,
+    -31267,
+    -31297,
+    -31327,
+    -31356,
+    -31385,
+    -31414,
+    -31442,
+    -31470,
+    -31498,
+    -31526,
+    -31553,
+    -31580,
+    -31607,
+    -31633,
+    -31659,
+    -31685,
+    -31710,
+    -31736,
+    -31760,
+    -31785,
+    -31809,
+    -31833,
+    -31857,
+    -31880,
+    -31903,
+    -31926,
+    -31949,
+    -31971,
+    -31993,
+    -32014,
+    -32036,
+    -32057,
+    -32077,
+    -32098,
+    -32118,
+    -32137,
+    -32157,
+    -32176,
+    -32195,
+    -32213,
+    -32232,
+    -32250,
+    -32267,
+    -32285,
+    -32302,
+    -32318,
+    -32335,
+    -32351,
+    -32367,
+    -32382,
+    -32397,
+    -32412,
+    -32427,
+    -32441,
+    -32455,
+    -32469,
+    -32482,
+    -32495,
+    -32508,
+    -32521,
+    -32533,
+    -32545,
+    -32556,
+    -32567,
+    -32578,
+    -32589,
+    -32599,
+    -32609,
+    -32619,
+    -32628,
+    -32637,
+    -32646,
+    -32655,
+    -32663,
+    -32671,
+    -32678,
+    -32685,
+    -32692,
+    -32699,
+    -32705,
+    -32711,
+    -32717,
+    -32722,
+    -32728,
+    -32732,
+    -32737,
+    -32741,
+    -32745,
+    -32748,
+    -32752,
+    -32755,
+    -32757,
+    -32759,
+    -32761,
+    -32763,
+    -32765,
+    -32766,
+    -32766,
+    -32767,
+    -32767,
+    -32767,
+    -32766,
+    -32766,
+    -32765,
+    -32763,
+    -32761,
+    -32759,
+    -32757,
+    -32755,
+    -32752,
+    -32748,
+    -32745,
+    -32741,
+    -32737,
+    -32732,
+    -32728,
+    -32722,
+    -32717,
+    -32711,
+    -32705,
+    -32699,
+    -32692,
+    -32685,
+    -32678,
+    -32671,
+    -32663,
+    -32655,
+    -32646,
+    -32637,
+    -32628,
+    -32619,
+    -32609,
+    -32599,
+    -32589,
+    -32578,
+    -32567,
+    -32556,
+    -32545,
+    -32533,
+    -32521,
+    -32508,
+    -32495,
+    -32482,
+    -32469,
+    -32455,
+    -32441,
+    -32427,
+    -32412,
+    -32397,
+    -32382,
+    -32367,
+    -32351,
+    -32335,
+    -32318,
+    -32302,
+    -32285,
+    -32267,
+    -32250,
+    -32232,
+    -32213,
+    -32195,
+    -32176,
+    -32157,
+    -32137,
+    -32118,
+    -32098,
+    -32077,
+    -32057,
+    -32036,
+    -32014,
+    -31993,
+    -31971,
+    -31949,
+    -31926,
+    -31903,
+    -31880,
+    -31857,
+    -31833,
+    -31809,
+    -31785,
+    -31760,
+    -31736,
+    -31710,
+    -31685,
+    -31659,
+    -31633,
+    -31607,
+    -31580,
+    -31553,
+    -31526,
+    -31498,
+    -31470,
+    -31442,
+    -31414,
+    -31385,
+    -31356,
+    -31327,
+    -31297,
+    -31267,
+    -31237,
+    -31206,
+    -31176,
+    -31145,
+    -31113,
+    -31082,
+    -31050,
+    -31017,
+    -30985,
+    -30952,
+    -30919,
+    -30885,
+    -30852,
+    -30818,
+    -30783,
+    -30749,
+    -30714,
+    -30679,
+    -30643,
+    -30607,
+    -30571,
+    -30535,
+    -30498,
+    -30462,
+    -30424,
+    -30387,
+    -30349,
+    -30311,
+    -30273,
+    -30234,
+    -30195,
+    -30156,
+    -30117,
+    -30077,
+    -30037,
+    -29997,
+    -29956,
+    -29915,
+    -29874,
+    -29832,
+    -29791,
+    -29749,
+    -29706,
+    -29664,
+    -29621,
+    -29578,
+    -29534,
+    -29491,
+    -29447,
+    -29403,
+    -29358,
+    -29313,
+    -29268,
+    -29223,
+    -29177,
+    -29131,
+    -29085,
+    -29039,
+    -28992,
+    -28945,
+    -28898,
+    -28850,
+    -28803,
+    -28755,
+    -28706,
+    -28658,
+    -28609,
+    -28560,
+    -28510,
+    -28460,
+    -28411,
+    -28360,
+    -28310,
+    -28259,
+    -28208,
+    -28157,
+    -28105,
+    -28053,
+    -28001,
+    -27949,
+    -27896,
+    -27843,
+    -27790,
+    -27737,
+    -27683,
+    -27629,
+    -27575,
+    -27521,
+    -27466,
+    -27411,
+    -27356,
+    -27300,
+    -27245,
+    -27189,
+    -27133,
+    -27076,
+    -27019,
+    -26962,
+    -26905,
+    -26848,
+    -26790,
+    -26732,
+    -26674,
+    -26615,
+    -26556,
+    -26497,
+    -26438,
+    -26378,
+    -26319,
+    -26259,
+    -26198,
+    -26138,
+    -26077,
+    -26016,
+    -25955,
+    -25893,
+    -25832,
+    -25770,
+    -25708,
+    -25645,
+    -25582,
+    -25519,
+    -25456,
+    -25393,
+    -25329,
+    -25265,
+    -25201,
+    -25137,
+    -25072,
+    -25007,
+    -24942,
+    -24877,
+    -24811,
+    -24746,
+    -24680,
+    -24613,
+    -24547,
+    -24480,
+    -24413,
+    -24346,
+    -24279,
+    -24211,
+    -24143,
+    -24075,
+    -24007,
+    -23938,
+    -23870,
+    -23801,
+    -23731,
+    -23662,
+    -23592,
+    -23522,
+    -23452,
+    -23382,
+    -23311,
+    -23241,
+    -23170,
+    -23099,
+    -23027,
+    -22956,
+    -22884,
+    -22812,
+    -22739,
+    -22667,
+    -22594,
+    -22521,
+    -22448,
+    -22375,
+    -22301,
+    -22227,
+    -22154,
+    -22079,
+    -22005,
+    -21930,
+    -21856,
+    -21781,
+    -21705,
+    -21630,
+    -21554,
+    -21479,
+    -21403,
+    -21326,
+    -21250,
+    -21173,
+    -21096,
+    -21019,
+    -20942,
+    -20865,
+    -20787,
+    -20709,
+    -20631,
+    -20553,
+    -20475,
+    -20396,
+    -20317,
+    -20238,
+    -20159,
+    -20080,
+    -20000,
+    -19921,
+    -19841,
+    -19761,
+    -19680,
+    -19600,
+    -19519,
+    -19438,
+    -19357,
+    -19276,
+    -19195,
+    -19113,
+    -19032,
+    -18950,
+    -18868,
+    -18785,
+    -18703,
+    -18620,
+    -18537,
+    -18454,
+    -18371,
+    -18288,
+    -18204,
+    -18121,
+    -18037,
+    -17953,
+    -17869,
+    -17784,
+    -17700,
+    -17615,
+    -17530,
+    -17445,
+    -17360,
+    -17275,
+    -17189,
+    -17104,
+    -17018,
+    -16932,
+    -16846,
+    -16759,
+    -16673,
+    -16586,
+    -16499,
+    -16413,
+    -16325,
+    -16238,
+    -16151,
+    -16063,
+    -15976,
+    -15888,
+    -15800,
+    -15712,
+    -15623,
+    -15535,
+    -15446,
+    -15358,
+    -15269,
+    -15180,
+    -15090,
+    -15001,
+    -14912,
+    -14822,
+    -14732,
+    -14643,
+    -14553,
+    -14462,
+    -14372,
+    -14282,
+    -14191,
+    -14101,
+    -14010,
+    -13919,
+    -13828,
+    -13736,
+    -13645,
+    -13554,
+    -13462,
+    -13370,
+    -13279,
+    -13187,
+    -13094,
+    -13002,
+    -12910,
+    -12817,
+    -12725,
+    -12632,
+    -12539,
+    -12446,
+    -12353,
+    -12260,
+    -12167,
+    -12074,
+    -11980,
+    -11886,
+    -11793,
+    -11699,
+    -11605,
+    -11511,
+    -11417,
+    -11322,
+    -11228,
+    -11133,
+    -11039,
+    -10944,
+    -10849,
+    -10754,
+    -10659,
+    -10564,
+    -10469,
+    -10374,
+    -10278,
+    -10183,
+    -10087,
+     -9992,
+     -9896,
+     -9800,
+     -9704,
+     -9608,
+     -9512,
+     -9416,
+     -9319,
+     -9223,
+     -9126,
+     -9030,
+     -8933,
+     -8836,
+     -8739,
+     -8642,
+     -8545,
+     -8448,
+     -8351,
+     -8254,
+     -8157,
+     -8059,
+     -7962,
+     -7864,
+     -7767,
+     -7669,
+     -7571,
+     -7473,
+     -7375,
+     -7277,
+     -7179,
+     -7081,
+     -6983,
+     -6885,
+     -6786,
+     -6688,
+     -6590,
+     -6491,
+     -6393,
+     -6294,
+     -6195,
+     -6096,
+     -5998,
+     -5899,
+     -5800,
+     -5701,
+     -5602,
+     -5503,
+     -5404,
+     -5305,
+     -5205,
+     -5106,
+     -5007,
+     -4907,
+     -4808,
+     -4708,
+     -4609,
+     -4509,
+     -4410,
+     -4310,
+     -4210,
+     -4111,
+     -4011,
+     -3911,
+     -3811,
+     -3712,
+     -3612,
+     -3512,
+     -3412,
+     -3312,
+     -3212,
+     -3112,
+     -3012,
+     -2911,
+     -2811,
+     -2711,
+     -2611,
+     -2511,
+     -2410,
+     -2310,
+     -2210,
+     -2110,
+     -2009,
+     -1909,
+     -1809,
+     -1708,
+     -1608,
+     -1507,
+     -1407,
+     -1307,
+     -1206,
+     -1106,
+     -1005,
+      -905,
+      -804,
+      -704,
+      -603,
+      -503,
+      -402,
+      -302,
+      -201,
+      -101
+};
+
+/* 32767*10^((level - DBM0_MAX_SINE_POWER)/20) for the levels from -63dBm0 to +3dBm0,
+   the amplitudes of sine waves of those powers */
+#define DBM0_GAIN_MIN_LEVEL     -63
+#define DBM0_GAIN_MAX_LEVEL     3
+
+static const int16_t dbm0_gain_table[DBM0_GAIN_MAX_LEVEL - DBM0_GAIN_MIN_LEVEL + 1] =
+{
+       16,    18,    20,    23,    26,    29,    32,    36,
+       41,    46,    51,    57,    64,    72,    81,    91,
+      102,   114,   128,   144,   162,   181,   203,   228,
+      256,   287,   322,   362,   406,   455,   511,   573,
+      643,   722,   810,   909,  1020,  1144,  1284,  1440,
+     1616,  1813,  2034,  2283,  2561,  2874,  3224,  3618,
+     4059,  4554,  5110,  5734,  6433,  7218,  8099,  9087,
+    10196, 11440, 12836, 14402, 16160, 18132, 20344, 22826,
+    25612, 28737, 32243
 };
 
-static int32_t dds_phase_ratef(float frequency)
+/* Returns -1 for the levels outside the table */
+static int32_t dds_scaling_dbm0(int level)
 {
-	return (int32_t) (frequency*65536.0f*65536.0f/SAMPLE_RATE);
+	if (level < DBM0_GAIN_MIN_LEVEL  ||  level > DBM0_GAIN_MAX_LEVEL)
+		return -1;
+	return dbm0_gain_table[level - DBM0_GAIN_MIN_LEVEL];
 }
 
-static float dds_scaling_dbm0f(float level)
+static __inline__ int32_t dds_lookup(uint32_t phase, int32_t scale)
 {
-	return powf(10.0f, (level - DBM0_MAX_SINE_POWER)/20.0f)*32767.0f;
+	return (sine_table[phase >> (32 - SLENK)]*scale + 0x4000) >> 15;
 }
 
-static float dds_modf(uint32_t *phase_acc, int32_t phase_rate, float scale, int32_t phase)
+static __inline__ int32_t dds_mod(uint32_t *phase_acc, int32_t phase_rate, int32_t scale)
 {
-	float amp;
-	amp = sine_table[*(phase_acc + phase) >> (32 - SLENK)]*scale;
+	int32_t amp;
+	amp = dds_lookup(*phase_acc, scale);
 	*phase_acc += phase_rate;
 	return amp;
 }
 
+/* Each sample's phases are worked out from the phases at the start, rather than
+   from the previous sample, so no sample depends on the one before and the loop
+   can be vectorised. The tones are mixed in 32 bits and only saturated when
+   going down to 16 bits. */
+static void dds_mix_scalar(int16_t amp[], int samples, uint32_t phase[4], const openr2_tone_gen_tone_descriptor_t tone[4], int tones)
+{
+	int32_t xamp;
+	int i;
+	int j;
+
+	for (j = 0;  j < samples;  j++)
+	{
+		xamp = 0;
+		for (i = 0;  i < tones;  i++)
+			xamp += dds_lookup(phase[i] + (uint32_t) j*(uint32_t) tone[i].phase_rate, tone[i].gain);
+		amp[j] = saturate(xamp);
+	}
+	for (i = 0;  i < tones;  i++)
+		phase[i] += (uint32_t) samples*(uint32_t) tone[i].phase_rate;
+}
+
+#if defined(OR2_DSP_X86)
+/* The same, 8 samples at a time. The sine table is gathered as 32 bit pairs of
+   entries, the one wanted being shifted down, so nothing past its end is read. */
+static OR2_DSP_TARGET_AVX2 void dds_mix_avx2(int16_t amp[], int samples, uint32_t phase[4], const openr2_tone_gen_tone_descriptor_t tone[4], int tones)
+{
+	__m256i n;
+	__m256i index;
+	__m256i x;
+	__m256i acc;
+	int i;
+	int j;
+
+	n = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (j = 0;  j + 8 <= samples;  j += 8)
+	{
+		acc = _mm256_setzero_si256();
+		for (i = 0;  i < tones;  i++)
+		{
+			index = _mm256_add_epi32(_mm256_set1_epi32((int32_t) phase[i]), _mm256_mullo_epi32(n, _mm256_set1_epi32(tone[i].phase_rate)));
+			index = _mm256_srli_epi32(index, 32 - SLENK);
+			x = _mm256_i32gather_epi32((const int *) sine_table, _mm256_srli_epi32(index, 1), 4);
+			x = _mm256_srlv_epi32(x, _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(1)), 4));
+			x = _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16);
+			x = _mm256_mullo_epi32(x, _mm256_set1_epi32(tone[i].gain));
+			acc = _mm256_add_epi32(acc, _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(0x4000)), 15));
+		}
+		/* Saturating pack, then put the two halves back in order */
+		x = _mm256_permute4x64_epi64(_mm256_packs_epi32(acc, acc), 0x08);
+		_mm_storeu_si128((__m128i *) &amp[j], _mm256_castsi256_si128(x));
+		n = _mm256_add_epi32(n, _mm256_set1_epi32(8));
+	}
+	for (i = 0;  i < tones;  i++)
+		phase[i] += (uint32_t) j*(uint32_t) tone[i].phase_rate;
+	dds_mix_scalar(&amp[j], samples - j, phase, tone, tones);
+}
+#endif
+
 
 /******* DTMF routines ********/
 
@@ -2682,56 +4226,74 @@ static float dds_modf(uint32_t *phase_acc, int32_t phase_rate, float scale, int3
 #define DTMF_RELATIVE_PEAK_COL      6.3f    /* 8dB */
 #define DTMF_TO_TOTAL_ENERGY        42.0f
 #define DTMF_POWER_OFFSET           90.30f
+/* As for MF, blocks whose filter input magnitudes sum below this can never
+   reach DTMF_THRESHOLD */
+#define DTMF_SILENCE_SUM            4000
+
+#if defined(OR2_USE_FIXED_POINT)
+/* Dialtone notch filter coefficients, as 64 bit to keep the filter sums from overflowing.
+   The notches are high Q, so their coefficients need far more precision than the
+   Goertzel ones to put the notches where the floating point build has them */
+#define DTMF_NOTCH_SHIFT            28
+#define DTMF_NOTCH_Q(x)             ((int64_t) ((x)*(double) (1 << DTMF_NOTCH_SHIFT) + 0.5))
+/* The notch states keep this many fraction bits, the filtered samples are rounded to integers.
+   A full scale sine peaks the states just under half the 32 bit range */
+#define DTMF_NOTCH_FRAC             8
+#define DTMF_NOTCH_HALF             (1 << (DTMF_NOTCH_FRAC - 1))
+#endif
 
 /* This is based on A-law, but u-law is only 0.03dB different */
 #define DBM0_MAX_POWER          (3.14f + 3.02f)
 
-static const float dtmf_row[] =
-{
-     697.0f,  770.0f,  852.0f,  941.0f
-};
-static const float dtmf_col[] =
-{
-    1209.0f, 1336.0f, 1477.0f, 1633.0f
-};
+/* -10dBm0, dbm0_gain_table[DEFAULT_DTMF_TX_LEVEL - DBM0_GAIN_MIN_LEVEL]. The
+   transmitter puts its own levels in when a digit starts anyway. */
+#define DTMF_TX_GAIN                7218
+
+#define DTMF_DIGIT_TONES(row, col) \
+    {{{DDS_PHASE_RATE(row), DTMF_TX_GAIN}, {DDS_PHASE_RATE(col), DTMF_TX_GAIN}}, \
+     {DEFAULT_DTMF_TX_ON_TIME*SAMPLE_RATE/1000, DEFAULT_DTMF_TX_OFF_TIME*SAMPLE_RATE/1000, 0, 0}, FALSE}
 
 static const char dtmf_positions[] = "123A" "456B" "789C" "*0#D";
-static openr2_goertzel_descriptor_t dtmf_detect_row[4];
-static openr2_goertzel_descriptor_t dtmf_detect_col[4];
 
-static int dtmf_tx_inited = FALSE;
-static openr2_tone_gen_descriptor_t dtmf_digit_tones[16];
+/* In the same order as dtmf_positions */
+static const openr2_tone_gen_descriptor_t dtmf_digit_tones[16] =
+{
+    DTMF_DIGIT_TONES(697, 1209), DTMF_DIGIT_TONES(697, 1336), DTMF_DIGIT_TONES(697, 1477), DTMF_DIGIT_TONES(697, 1633),
+    DTMF_DIGIT_TONES(770, 1209), DTMF_DIGIT_TONES(770, 1336), DTMF_DIGIT_TONES(770, 1477), DTMF_DIGIT_TONES(770, 1633),
+    DTMF_DIGIT_TONES(852, 1209), DTMF_DIGIT_TONES(852, 1336), DTMF_DIGIT_TONES(852, 1477), DTMF_DIGIT_TONES(852, 1633),
+    DTMF_DIGIT_TONES(941, 1209), DTMF_DIGIT_TONES(941, 1336), DTMF_DIGIT_TONES(941, 1477), DTMF_DIGIT_TONES(941, 1633)
+};
 
-static void dtmf_tx_initialise(void)
+/* As for MF, 2cos(2*pi*f/SAMPLE_RATE) worked out ahead of time */
+static const openr2_goertzel_descriptor_t dtmf_detect_row[4] =
 {
-    int row;
-    int col;
+    GOERTZEL_DESCRIPTOR(1.7077378f, 27980, OR2_DTMF_RX_BLOCK_SAMPLES),    /*  697Hz */
+    GOERTZEL_DESCRIPTOR(1.64528108f, 26956, OR2_DTMF_RX_BLOCK_SAMPLES),   /*  770Hz */
+    GOERTZEL_DESCRIPTOR(1.56868696f, 25701, OR2_DTMF_RX_BLOCK_SAMPLES),   /*  852Hz */
+    GOERTZEL_DESCRIPTOR(1.47820449f, 24219, OR2_DTMF_RX_BLOCK_SAMPLES)    /*  941Hz */
+};
 
-    if (dtmf_tx_inited)
-        return;
-    for (row = 0;  row < 4;  row++)
-    {
-        for (col = 0;  col < 4;  col++)
-        {
-            make_tone_gen_descriptor(&dtmf_digit_tones[row*4 + col],
-                                     (int) dtmf_row[row],
-                                     DEFAULT_DTMF_TX_LEVEL,
-                                     (int) dtmf_col[col],
-                                     DEFAULT_DTMF_TX_LEVEL,
-                                     DEFAULT_DTMF_TX_ON_TIME,
-                                     DEFAULT_DTMF_TX_OFF_TIME,
-                                     0,
-                                     0,
-                                     FALSE);
-        }
-    }
-    dtmf_tx_inited = TRUE;
-}
+static const openr2_goertzel_descriptor_t dtmf_detect_col[4] =
+{
+    GOERTZEL_DESCRIPTOR(1.16410398f, 19073, OR2_DTMF_RX_BLOCK_SAMPLES),   /* 1209Hz */
+    GOERTZEL_DESCRIPTOR(0.996370196f, 16325, OR2_DTMF_RX_BLOCK_SAMPLES),  /* 1336Hz */
+    GOERTZEL_DESCRIPTOR(0.798618376f, 13085, OR2_DTMF_RX_BLOCK_SAMPLES),  /* 1477Hz */
+    GOERTZEL_DESCRIPTOR(0.568532646f, 9315, OR2_DTMF_RX_BLOCK_SAMPLES)    /* 1633Hz */
+};
 
-OR2_DECLARE(void) openr2_dtmf_tx_set_level(openr2_dtmf_tx_state_t *s, int level, int twist)
+OR2_DECLARE(int) openr2_dtmf_tx_set_level(openr2_dtmf_tx_state_t *s, int level, int twist)
 {
-    s->low_level = dds_scaling_dbm0f((float) level);
-    s->high_level = dds_scaling_dbm0f((float) (level + twist));
+    int32_t low_level;
+    int32_t high_level;
+
+    /* keep the current levels rather than sending tones other than asked for */
+    if ((low_level = dds_scaling_dbm0(level)) < 0)
+        return -1;
+    if ((high_level = dds_scaling_dbm0(level + twist)) < 0)
+        return -1;
+    s->low_level = low_level;
+    s->high_level = high_level;
+    return 0;
 }
 
 OR2_DECLARE(openr2_dtmf_tx_state_t *) openr2_dtmf_tx_init(openr2_dtmf_tx_state_t *s)
@@ -2741,8 +4303,6 @@ OR2_DECLARE(openr2_dtmf_tx_state_t *) openr2_dtmf_tx_init(openr2_dtmf_tx_state_t
         if ((s = (openr2_dtmf_tx_state_t *) malloc(sizeof (*s))) == NULL)
             return  NULL;
     }
-    if (!dtmf_tx_inited)
-        dtmf_tx_initialise();
     tone_gen_init(&(s->tones), &dtmf_digit_tones[0]);
     openr2_dtmf_tx_set_level(s, DEFAULT_DTMF_TX_LEVEL, 0);
     openr2_dtmf_tx_set_timing(s, -1, -1);
@@ -2805,12 +4365,30 @@ OR2_DECLARE(int) openr2_dtmf_tx(openr2_dtmf_tx_state_t *s, int16_t amp[], int ma
     return len;
 }
 
+OR2_DECLARE(int) openr2_dtmf_tx_alaw(openr2_dtmf_tx_state_t *s, uint8_t alaw[], int max_samples)
+{
+    int16_t amp[SAMPLE_RATE/50];
+    int len;
+    int i;
+
+    /* Generate in small linear chunks and encode each one while it is still hot */
+    for (len = 0;  len < max_samples;  len += i)
+    {
+        i = max_samples - len;
+        if (i > SAMPLE_RATE/50)
+            i = SAMPLE_RATE/50;
+        if ((i = openr2_dtmf_tx(s, amp, i)) <= 0)
+            break;
+        openr2_linear_to_alaw_n(amp, &alaw[len], i);
+    }
+    return len;
+}
+
 OR2_DECLARE(openr2_dtmf_rx_state_t *) openr2_dtmf_rx_init(openr2_dtmf_rx_state_t *s,
                               openr2_digits_rx_callback_t callback,
                               void *user_data)
 {
     int i;
-    static int initialised = FALSE;
 
     if (s == NULL)
     {
@@ -2828,21 +4406,13 @@ OR2_DECLARE(openr2_dtmf_rx_state_t *) openr2_dtmf_rx_init(openr2_dtmf_rx_state_t
     s->in_digit = 0;
     s->last_hit = 0;
 
-    if (!initialised)
-    {
-        for (i = 0;  i < 4;  i++)
-        {
-            make_goertzel_descriptor(&dtmf_detect_row[i], dtmf_row[i], 102);
-            make_goertzel_descriptor(&dtmf_detect_col[i], dtmf_col[i], 102);
-        }
-        initialised = TRUE;
-    }
     for (i = 0;  i < 4;  i++)
     {
         goertzel_init(&s->row_out[i], &dtmf_detect_row[i]);
         goertzel_init(&s->col_out[i], &dtmf_detect_col[i]);
     }
     s->energy = 0.0f;
+    s->silence_sum = 0;
     s->current_sample = 0;
     s->lost_digits = 0;
     s->current_digits = 0;
@@ -2850,17 +4420,80 @@ OR2_DECLARE(openr2_dtmf_rx_state_t *) openr2_dtmf_rx_init(openr2_dtmf_rx_state_t
     return s;
 }
 
-OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[], int samples)
+/* Decide which digit, if any, the filters and the energy of a DTMF detection block represent */
+static int dtmf_rx_block_digit(openr2_dtmf_rx_state_t *s)
 {
     float row_energy[4];
     float col_energy[4];
-    float famp;
-    float v1;
+    int best_row;
+    int best_col;
+    int hit;
+    int i;
+
+    /* Find the peak row and the peak column */
+    row_energy[0] = goertzel_result(&s->row_out[0]);
+    best_row = 0;
+    col_energy[0] = goertzel_result(&s->col_out[0]);
+    best_col = 0;
+
+    for (i = 1;  i < 4;  i++)
+    {
+        row_energy[i] = goertzel_result(&s->row_out[i]);
+        if (row_energy[i] > row_energy[best_row])
+            best_row = i;
+        col_energy[i] = goertzel_result(&s->col_out[i]);
+        if (col_energy[i] > col_energy[best_col])
+            best_col = i;
+    }
+    hit = 0;
+    /* Basic signal level test and the twist test */
+    if (row_energy[best_row] >= DTMF_THRESHOLD
+        &&
+        col_energy[best_col] >= DTMF_THRESHOLD
+        &&
+        col_energy[best_col] < row_energy[best_row]*s->reverse_twist
+        &&
+        col_energy[best_col]*s->normal_twist > row_energy[best_row])
+    {
+        /* Relative peak test ... */
+        for (i = 0;  i < 4;  i++)
+        {
+            if ((i != best_col  &&  col_energy[i]*DTMF_RELATIVE_PEAK_COL > col_energy[best_col])
+                ||
+                (i != best_row  &&  row_energy[i]*DTMF_RELATIVE_PEAK_ROW > row_energy[best_row]))
+            {
+                break;
+            }
+        }
+        /* ... and fraction of total energy test */
+        if (i >= 4
+            &&
+            (row_energy[best_row] + col_energy[best_col]) > DTMF_TO_TOTAL_ENERGY*s->energy)
+        {
+            /* Got a hit */
+            hit = dtmf_positions[(best_row << 2) + best_col];
+        }
+    }
+    return hit;
+}
+
+static int dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[], const uint8_t alaw[], int samples)
+{
+    openr2_goertzel_value_t filtered[OR2_DTMF_RX_BLOCK_SAMPLES];
+    openr2_goertzel_value_t *buf;
+    openr2_goertzel_value_t sum;
+    openr2_goertzel_value_t z350[2];
+    openr2_goertzel_value_t z440[2];
+    openr2_goertzel_value_t famp;
+    openr2_goertzel_value_t v1;
+#if defined(OR2_USE_FIXED_POINT)
+    int64_t energy;
+#else
+    float energy;
+#endif
     int i;
     int j;
     int sample;
-    int best_row;
-    int best_col;
     int limit;
     uint8_t hit;
 
@@ -2872,109 +4505,99 @@ OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[],
             limit = sample + (102 - s->current_sample);
         else
             limit = samples;
-        /* The following unrolled loop takes only 35% (rough estimate) of the 
-           time of a rolled loop on the machine on which it was developed */
-        for (j = sample;  j < limit;  j++)
+        /* First the serial part, the dialtone notches and the total energy, into
+           a buffer. Then all the Goertzel filters together over that buffer. While
+           the block is quiet enough to never hold a digit the filtered samples are
+           kept aside instead, and only run through the filters if that changes. */
+        buf = (s->silence_sum >= 0)  ?  &s->replay[s->current_sample]  :  filtered;
+        sum = s->silence_sum;
+        energy = s->energy;
+        if (s->filter_dialtone)
         {
-            famp = amp[j];
-            if (s->filter_dialtone)
+            z350[0] = s->z350[0];
+            z350[1] = s->z350[1];
+            z440[0] = s->z440[0];
+            z440[1] = s->z440[1];
+            for (j = sample;  j < limit;  j++)
             {
+                famp = detector_sample(amp, alaw, j);
                 /* Sharp notches applied at 350Hz and 440Hz - the two common dialtone frequencies.
                    These are rather high Q, to achieve the required narrowness, without using lots of
                    sections. */
-                v1 = 0.98356f*famp + 1.8954426f*s->z350[0] - 0.9691396f*s->z350[1];
-                famp = v1 - 1.9251480f*s->z350[0] + s->z350[1];
-                s->z350[1] = s->z350[0];
-                s->z350[0] = v1;
-
-                v1 = 0.98456f*famp + 1.8529543f*s->z440[0] - 0.9691396f*s->z440[1];
-                famp = v1 - 1.8819938f*s->z440[0] + s->z440[1];
-                s->z440[1] = s->z440[0];
-                s->z440[0] = v1;
+#if defined(OR2_USE_FIXED_POINT)
+                v1 = (openr2_goertzel_value_t) ((DTMF_NOTCH_Q(0.98356f*(1 << DTMF_NOTCH_FRAC))*famp + DTMF_NOTCH_Q(1.8954426f)*z350[0] - DTMF_NOTCH_Q(0.9691396f)*z350[1]) >> DTMF_NOTCH_SHIFT);
+                famp = (v1 + z350[1] - (openr2_goertzel_value_t) ((DTMF_NOTCH_Q(1.9251480f)*z350[0]) >> DTMF_NOTCH_SHIFT) + DTMF_NOTCH_HALF) >> DTMF_NOTCH_FRAC;
+                z350[1] = z350[0];
+                z350[0] = v1;
+
+                v1 = (openr2_goertzel_value_t) ((DTMF_NOTCH_Q(0.98456f*(1 << DTMF_NOTCH_FRAC))*famp + DTMF_NOTCH_Q(1.8529543f)*z440[0] - DTMF_NOTCH_Q(0.9691396f)*z440[1]) >> DTMF_NOTCH_SHIFT);
+                famp = (v1 + z440[1] - (openr2_goertzel_value_t) ((DTMF_NOTCH_Q(1.8819938f)*z440[0]) >> DTMF_NOTCH_SHIFT) + DTMF_NOTCH_HALF) >> DTMF_NOTCH_FRAC;
+                z440[1] = z440[0];
+                z440[0] = v1;
+                energy += (int64_t) famp*famp;
+                sum += abs(famp);
+#else
+                v1 = 0.98356f*famp + 1.8954426f*z350[0] - 0.9691396f*z350[1];
+                famp = v1 - 1.9251480f*z350[0] + z350[1];
+                z350[1] = z350[0];
+                z350[0] = v1;
+
+                v1 = 0.98456f*famp + 1.8529543f*z440[0] - 0.9691396f*z440[1];
+                famp = v1 - 1.8819938f*z440[0] + z440[1];
+                z440[1] = z440[0];
+                z440[0] = v1;
+                energy += famp*famp;
+                sum += fabsf(famp);
+#endif
+                buf[j - sample] = famp;
+            }
+            s->z350[0] = z350[0];
+            s->z350[1] = z350[1];
+            s->z440[0] = z440[0];
+            s->z440[1] = z440[1];
+        }
+        else
+        {
+            for (j = sample;  j < limit;  j++)
+            {
+                famp = detector_sample(amp, alaw, j);
+#if defined(OR2_USE_FIXED_POINT)
+                energy += (int64_t) famp*famp;
+                sum += abs(famp);
+#else
+                energy += famp*famp;
+                sum += fabsf(famp);
+#endif
+                buf[j - sample] = famp;
             }
-            s->energy += famp*famp;
-            /* With GCC 2.95, the following unrolled code seems to take about 35%
-               (rough estimate) as long as a neat little 0-3 loop */
-            v1 = s->row_out[0].v2;
-            s->row_out[0].v2 = s->row_out[0].v3;
-            s->row_out[0].v3 = s->row_out[0].fac*s->row_out[0].v2 - v1 + famp;
-
-            v1 = s->col_out[0].v2;
-            s->col_out[0].v2 = s->col_out[0].v3;
-            s->col_out[0].v3 = s->col_out[0].fac*s->col_out[0].v2 - v1 + famp;
-
-            v1 = s->row_out[1].v2;
-            s->row_out[1].v2 = s->row_out[1].v3;
-            s->row_out[1].v3 = s->row_out[1].fac*s->row_out[1].v2 - v1 + famp;
-
-            v1 = s->col_out[1].v2;
-            s->col_out[1].v2 = s->col_out[1].v3;
-            s->col_out[1].v3 = s->col_out[1].fac*s->col_out[1].v2 - v1 + famp;
-
-            v1 = s->row_out[2].v2;
-            s->row_out[2].v2 = s->row_out[2].v3;
-            s->row_out[2].v3 = s->row_out[2].fac*s->row_out[2].v2 - v1 + famp;
-
-            v1 = s->col_out[2].v2;
-            s->col_out[2].v2 = s->col_out[2].v3;
-            s->col_out[2].v3 = s->col_out[2].fac*s->col_out[2].v2 - v1 + famp;
-
-            v1 = s->row_out[3].v2;
-            s->row_out[3].v2 = s->row_out[3].v3;
-            s->row_out[3].v3 = s->row_out[3].fac*s->row_out[3].v2 - v1 + famp;
-
-            v1 = s->col_out[3].v2;
-            s->col_out[3].v2 = s->col_out[3].v3;
-            s->col_out[3].v3 = s->col_out[3].fac*s->col_out[3].v2 - v1 + famp;
+        }
+        s->energy = energy;
+        if (s->silence_sum < 0)
+        {
+            dsp->goertzel_update_dtmf(s->row_out, s->col_out, filtered, limit - sample);
+        }
+        else if (sum > DTMF_SILENCE_SUM)
+        {
+            dsp->goertzel_update_dtmf(s->row_out, s->col_out, s->replay, s->current_sample + limit - sample);
+            s->silence_sum = -1;
+        }
+        else
+        {
+            s->silence_sum = sum;
         }
         s->current_sample += (limit - sample);
         if (s->current_sample < 102)
             continue;
 
         /* We are at the end of a DTMF detection block */
-        /* Find the peak row and the peak column */
-        row_energy[0] = goertzel_result(&s->row_out[0]);
-        best_row = 0;
-        col_energy[0] = goertzel_result(&s->col_out[0]);
-        best_col = 0;
-
-        for (i = 1;  i < 4;  i++)
+        if (s->silence_sum >= 0)
         {
-            row_energy[i] = goertzel_result(&s->row_out[i]);
-            if (row_energy[i] > row_energy[best_row])
-                best_row = i;
-            col_energy[i] = goertzel_result(&s->col_out[i]);
-            if (col_energy[i] > col_energy[best_col])
-                best_col = i;
+            /* Too quiet for any digit, the filters were never needed */
+            hit = 0;
         }
-        hit = 0;
-        /* Basic signal level test and the twist test */
-        if (row_energy[best_row] >= DTMF_THRESHOLD
-            &&
-            col_energy[best_col] >= DTMF_THRESHOLD
-            &&
-            col_energy[best_col] < row_energy[best_row]*s->reverse_twist
-            &&
-            col_energy[best_col]*s->normal_twist > row_energy[best_row])
+        else
         {
-            /* Relative peak test ... */
-            for (i = 0;  i < 4;  i++)
-            {
-                if ((i != best_col  &&  col_energy[i]*DTMF_RELATIVE_PEAK_COL > col_energy[best_col])
-                    ||
-                    (i != best_row  &&  row_energy[i]*DTMF_RELATIVE_PEAK_ROW > row_energy[best_row]))
-                {
-                    break;
-                }
-            }
-            /* ... and fraction of total energy test */
-            if (i >= 4
-                &&
-                (row_energy[best_row] + col_energy[best_col]) > DTMF_TO_TOTAL_ENERGY*s->energy)
-            {
-                /* Got a hit */
-                hit = dtmf_positions[(best_row << 2) + best_col];
-            }
+            hit = dtmf_rx_block_digit(s);
         }
         /* The logic in the next test should ensure the following for different successive hit patterns:
                 -----ABB = start of digit B.
@@ -3048,6 +4671,7 @@ OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[],
             goertzel_reset(&s->col_out[i]);
         }
         s->energy = 0.0f;
+        s->silence_sum = 0;
         s->current_sample = 0;
     }
     if (s->current_digits  &&  s->digits_callback)
@@ -3059,6 +4683,16 @@ OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[],
     return 0;
 }
 
+OR2_DECLARE(int) openr2_dtmf_rx(openr2_dtmf_rx_state_t *s, const int16_t amp[], int samples)
+{
+    return dtmf_rx(s, amp, NULL, samples);
+}
+
+OR2_DECLARE(int) openr2_dtmf_rx_alaw(openr2_dtmf_rx_state_t *s, const uint8_t alaw[], int samples)
+{
+    return dtmf_rx(s, NULL, alaw, samples);
+}
+
 OR2_DECLARE(int) openr2_dtmf_rx_status(openr2_dtmf_rx_state_t *s)
 {
     if (s->in_digit)
@@ -3068,3 +4702,103 @@ OR2_DECLARE(int) openr2_dtmf_rx_status(openr2_dtmf_rx_state_t *s)
     return 0;
 }
 
+/******* DSP kernel dispatch ********/
+
+/* Indexed by openr2_dsp_variant_t. Variants not built for this target are all NULL.
+   Kernels with nothing to gain from an instruction set use the scalar code. */
+static const dsp_kernels_t dsp_kernels[OR2_DSP_VARIANTS] =
+{
+    {goertzel_update_mf_scalar, goertzel_update_dtmf_scalar, goertzel_update_mf_dual_scalar, goertzel_update_mf_bank_scalar, dds_mix_scalar, alaw_to_linear_scalar, linear_to_alaw_scalar},
+#if defined(OR2_DSP_X86)
+    {goertzel_update_mf_sse2, goertzel_update_dtmf_sse2, goertzel_update_mf_dual_sse2, goertzel_update_mf_bank_sse2, dds_mix_scalar, alaw_to_linear_scalar, linear_to_alaw_scalar},
+    {goertzel_update_mf_avx2, goertzel_update_dtmf_avx2, goertzel_update_mf_dual_avx2, goertzel_update_mf_bank_avx2, dds_mix_avx2, alaw_to_linear_avx2, linear_to_alaw_avx2},
+#else
+    {NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+    {NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+#endif
+#if defined(OR2_DSP_NEON)
+    {goertzel_update_mf_neon, goertzel_update_dtmf_neon, goertzel_update_mf_dual_neon, goertzel_update_mf_bank_neon, dds_mix_scalar, alaw_to_linear_scalar, linear_to_alaw_scalar}
+#else
+    {NULL, NULL, NULL, NULL, NULL, NULL, NULL}
+#endif
+};
+
+static const char *dsp_variant_names[OR2_DSP_VARIANTS] =
+{
+    "scalar",
+    "sse2",
+    "avx2",
+    "neon"
+};
+
+/* Compilers without constructors just stay on the scalar kernels unless told otherwise */
+static const dsp_kernels_t *volatile dsp = &dsp_kernels[OR2_DSP_SCALAR];
+
+#if defined(__GNUC__)
+#define OR2_DSP_CONSTRUCTOR __attribute__((constructor))
+#else
+#define OR2_DSP_CONSTRUCTOR
+#endif
+
+static int dsp_variant_supported(int variant)
+{
+    if (variant < 0  ||  variant >= OR2_DSP_VARIANTS  ||  dsp_kernels[variant].goertzel_update_mf == NULL)
+        return FALSE;
+#if defined(OR2_DSP_X86)
+    if (variant == OR2_DSP_SSE2)
+        return __builtin_cpu_supports("sse2");
+    if (variant == OR2_DSP_AVX2)
+        return __builtin_cpu_supports("avx2");
+#endif
+    return TRUE;
+}
+
+/* Pick the kernels once, when the library is loaded. OPENR2_DSP can name the
+   variant to use instead of the best one, for benchmarking. */
+static OR2_DSP_CONSTRUCTOR void dsp_select(void)
+{
+    const char *name;
+    int variant;
+
+#if defined(OR2_DSP_X86)
+    __builtin_cpu_init();
+#endif
+    if ((name = getenv("OPENR2_DSP")))
+    {
+        for (variant = 0;  variant < OR2_DSP_VARIANTS;  variant++)
+        {
+            if (!strcmp(name, dsp_variant_names[variant])  &&  dsp_variant_supported(variant))
+            {
+                dsp = &dsp_kernels[variant];
+                return;
+            }
+        }
+    }
+    /* The variants are listed from the least to the most capable */
+    for (variant = OR2_DSP_VARIANTS - 1;  variant > OR2_DSP_SCALAR;  variant--)
+    {
+        if (dsp_variant_supported(variant))
+            break;
+    }
+    dsp = &dsp_kernels[variant];
+}
+
+OR2_DECLARE(int) openr2_dsp_set_variant(openr2_dsp_variant_t variant)
+{
+    if (!dsp_variant_supported(variant))
+        return -1;
+    dsp = &dsp_kernels[variant];
+    return 0;
+}
+
+OR2_DECLARE(openr2_dsp_variant_t) openr2_dsp_get_variant(void)
+{
+    return (openr2_dsp_variant_t) (dsp - dsp_kernels);
+}
+
+OR2_DECLARE(const char *) openr2_dsp_get_variant_name(openr2_dsp_variant_t variant)
+{
+    if (variant < 0  ||  variant >= OR2_DSP_VARIANTS)
+        return "*Unknown*";
+    return dsp_variant_names[variant];
+}
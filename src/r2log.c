@@ -88,7 +88,7 @@ void openr2_log_channel_default(openr2_chan_t *r2chan, const char *file, const c
 	struct timeval currtime;
 	time_t currsec;
 	struct tm currtime_tm;
-	int res = gettimeofday(&currtime, NULL);
+	int res = openr2_chan_get_wallclock(r2chan, &currtime);
 	if (-1 == res) {
 		fprintf(stderr, "gettimeofday failed!\n");
 		return;
@@ -113,7 +113,7 @@ static void log_at_file(openr2_chan_t *r2chan, const char *fmt, va_list ap)
 	struct timeval currtime;
 	time_t currsec;
 	struct tm currtime_tm;
-	int res = gettimeofday(&currtime, NULL);
+	int res = openr2_chan_get_wallclock(r2chan, &currtime);
 	if (-1 == res) {
 		fprintf(stderr, "gettimeofday failed!\n");
 		return;
@@ -47,13 +47,12 @@ int main(int argc, char *argv[])
 	char *chunk_buffer;
 	size_t chunksize = 0;
 	int format = FORMAT_INVALID;
-	int i = 0;
-	char digit = 0;
+	int fwd_digit = 0;
+	int bwd_digit = 0;
 	char bwd_currdigit = 0;
 	char fwd_currdigit = 0;
 	int processed_samples = 0;
-	openr2_mf_rx_state_t  fwd_rxstate;
-	openr2_mf_rx_state_t  bwd_rxstate;
+	openr2_mf_rx_dual_state_t rxstate;
 
 	printf("Running MF Detection Test - alaw or slinear 8000hz only\n");
 
@@ -87,40 +86,34 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
-	if (!openr2_mf_rx_init(&bwd_rxstate, 0)) {
-		fprintf(stderr, "could not create backward rx state\n");
-		exit(1);
-	}
-
-	if (!openr2_mf_rx_init(&fwd_rxstate, 1)) {
-		fprintf(stderr, "could not create forward rx state\n");
+	if (!openr2_mf_rx_dual_init(&rxstate)) {
+		fprintf(stderr, "could not create rx state\n");
 		exit(1);
 	}
 
 	while (fread(chunk_buffer, chunksize, 1, audiofp) == 1) {
+		processed_samples += CHUNK_SAMPLES;
+
+		/* both directions are detected in a single pass over the samples */
 		if (format == FORMAT_ALAW) {
 			/* chunksize == bytes == samples */
-			for (i = 0; i < chunksize; i++) {
-				slinear_buffer[i] = openr2_alaw_to_linear(chunk_buffer[i]);
-			}
-		} 
-
-		processed_samples += CHUNK_SAMPLES;
+			openr2_mf_rx_dual_alaw(&rxstate, (uint8_t *)alaw_buffer, CHUNK_SAMPLES, &fwd_digit, &bwd_digit);
+		} else {
+			openr2_mf_rx_dual(&rxstate, slinear_buffer, CHUNK_SAMPLES, &fwd_digit, &bwd_digit);
+		}
 
-		digit = openr2_mf_rx(&bwd_rxstate, slinear_buffer, CHUNK_SAMPLES);
-		if (digit && digit != bwd_currdigit) {
-			bwd_currdigit = digit;
+		if (bwd_digit && bwd_digit != bwd_currdigit) {
+			bwd_currdigit = bwd_digit;
 			printf("Backward %c ON (samples = %d, ms = %d)\n", bwd_currdigit, processed_samples, samples_to_ms(processed_samples));
-		} else if (!digit && bwd_currdigit) {
+		} else if (!bwd_digit && bwd_currdigit) {
 			printf("Backward %c OFF (samples = %d, ms %d)\n", bwd_currdigit, processed_samples, samples_to_ms(processed_samples));
 			bwd_currdigit = 0;
 		}
 
-		digit = openr2_mf_rx(&fwd_rxstate, slinear_buffer, CHUNK_SAMPLES);
-		if (digit && digit != fwd_currdigit) {
-			fwd_currdigit = digit;
+		if (fwd_digit && fwd_digit != fwd_currdigit) {
+			fwd_currdigit = fwd_digit;
 			printf("Forward %c ON (samples = %d, ms = %d)\n", fwd_currdigit, processed_samples, samples_to_ms(processed_samples));
-		} else if (!digit && fwd_currdigit) {
+		} else if (!fwd_digit && fwd_currdigit) {
 			printf("Forward %c OFF (samples = %d, ms = %d)\n", fwd_currdigit, processed_samples, samples_to_ms(processed_samples));
 			fwd_currdigit = 0;
 		}
@@ -943,6 +943,7 @@ static void handle_incoming_call(openr2_chan_t *r2chan)
 			handle_protocol_error(r2chan, OR2_INTERNAL_ERROR);
 			return;
 		}
+		openr2_context_configure_mf_rx(r2chan->r2context, mf_read_handle);
 		r2chan->mf_write_handle = mf_write_handle;
 		r2chan->mf_read_handle = mf_read_handle;
 		r2chan->mf_state = OR2_MF_SEIZE_ACK_TXD;
@@ -1277,6 +1278,7 @@ handlecas:
 				r2chan->mf_group = OR2_MF_GI;
 				MFI(r2chan)->mf_write_init(r2chan->mf_write_handle, 1);
 				MFI(r2chan)->mf_read_init(r2chan->mf_read_handle, 0);
+				openr2_context_configure_mf_rx(r2chan->r2context, r2chan->mf_read_handle);
 				mf_send_dnis(r2chan, 0);
 			} else {
 				/* handle seize ack for DTMF R2 */
@@ -2340,37 +2342,16 @@ static void handle_backward_mf_silence(openr2_chan_t *r2chan, int tone)
 	}
 }
 
-static int timediff(struct timeval *t1, struct timeval *t2)
-{
-	int msdiff = 0;
-	if (t1->tv_sec == t2->tv_sec) {
-		return ((t1->tv_usec - t2->tv_usec)/1000);
-	}
-	msdiff  = (t1->tv_usec) ? (t1->tv_usec/1000)          : 0;
-	msdiff += (t2->tv_usec) ? (1000 - (t2->tv_usec/1000)) : 0;
-	return msdiff;
-}
-
 static int check_threshold(openr2_chan_t *r2chan, int tone)
 {
-	int res = 0;
 	int tone_threshold = 0;
-	struct timeval currtime = {0, 0};
 	if (r2chan->r2context->mf_threshold) {
 		if (r2chan->mf_threshold_tone != tone) {
-			res = gettimeofday(&r2chan->mf_threshold_time, NULL);
-			if (-1 == res) {
-				openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "gettimeofday failed when setting threshold time\n");
-				return -1;
-			}
+			r2chan->mf_threshold_sample = r2chan->mf_rx_samples;
 			r2chan->mf_threshold_tone = tone;
 		}
-		res = gettimeofday(&currtime, NULL);
-		if (-1 == res) {
-			openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_ERROR, "gettimeofday failed when checking tone length\n");
-			return -1;
-		}
-		tone_threshold = timediff(&currtime, &r2chan->mf_threshold_time);
+		/* 8 samples per ms */
+		tone_threshold = (int)((uint32_t)(r2chan->mf_rx_samples - r2chan->mf_threshold_sample) / 8);
 		if (tone_threshold < r2chan->r2context->mf_threshold) {
 			if (tone) {
 				openr2_log(r2chan, OR2_CHANNEL_LOG, OR2_LOG_EX_DEBUG, "Tone %c ignored\n", tone);
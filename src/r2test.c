@@ -100,6 +100,8 @@ typedef struct chan_group_data_s {
 	int getanifirst;
 	int usedahdimf;
 	int mf_threshold;
+	int mf_block;
+	int mf_hop;
 	int mf_backtimeout;
 	int callfiles;
 	int meteringpulse_timeout;
@@ -415,6 +417,8 @@ static int parse_config(FILE *conf, chan_group_data_t *confdata)
 	int getanifirst = 0;
 	int usedahdimf = 0;
 	int mf_threshold = 0;
+	int mf_block = 0;
+	int mf_hop = 0;
 	int mf_backtimeout = 0;
 	int int_test = 0;
 	int callfiles = 0;
@@ -462,6 +466,8 @@ static int parse_config(FILE *conf, chan_group_data_t *confdata)
 			confdata[g].loglevel = loglevel;
 			confdata[g].usedahdimf = usedahdimf;
 			confdata[g].mf_threshold = mf_threshold;
+			confdata[g].mf_block = mf_block;
+			confdata[g].mf_hop = mf_hop;
 			confdata[g].mf_backtimeout = mf_backtimeout;
 			confdata[g].callfiles = callfiles;
 			confdata[g].meteringpulse_timeout = meteringpulse_timeout;
@@ -571,6 +577,22 @@ static int parse_config(FILE *conf, chan_group_data_t *confdata)
 				continue;
 			}
 			mf_threshold = int_test;
+		} else if (1 == sscanf(line, "mfblock=%s", strvalue)) {
+			printf("found option MF block = %s\n", strvalue);
+			int_test = atoi(strvalue);
+			if (!int_test && strvalue[0] != '0') {
+				fprintf(stderr, "Invalid value '%s' for 'mfblock' parameter.\n", strvalue);
+				continue;
+			}
+			mf_block = int_test;
+		} else if (1 == sscanf(line, "mfhop=%s", strvalue)) {
+			printf("found option MF hop = %s\n", strvalue);
+			int_test = atoi(strvalue);
+			if (!int_test && strvalue[0] != '0') {
+				fprintf(stderr, "Invalid value '%s' for 'mfhop' parameter.\n", strvalue);
+				continue;
+			}
+			mf_hop = int_test;
 		} else if (1 == sscanf(line, "mfbacktimeout=%s", strvalue)) {
 			printf("found option MF backward timeout = %s\n", strvalue);
 			int_test = atoi(strvalue);
@@ -833,6 +855,7 @@ int main(int argc, char *argv[])
 		openr2_context_set_log_level(g_confdata[c].context, g_confdata[c].loglevel);
 		openr2_context_set_ani_first(g_confdata[c].context, g_confdata[c].getanifirst);
 		openr2_context_set_mf_threshold(g_confdata[c].context, g_confdata[c].mf_threshold);
+		openr2_context_set_mf_block(g_confdata[c].context, g_confdata[c].mf_block, g_confdata[c].mf_hop);
 		openr2_context_set_mf_back_timeout(g_confdata[c].context, g_confdata[c].mf_backtimeout);
 		openr2_context_set_metering_pulse_timeout(g_confdata[c].context, g_confdata[c].meteringpulse_timeout);
 		openr2_context_set_double_answer(g_confdata[c].context, g_confdata[c].double_answer);
@@ -22,6 +22,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* pthread_setaffinity_np() and the CPU_SET() macros */
+#define _GNU_SOURCE
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -42,6 +47,12 @@
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 
 #define _openr2_assert(assertion, msg) \
 	if (!(assertion)) { \
@@ -110,6 +121,13 @@ static void * OR2_THREAD_CALLING_CONVENTION thread_launch(void *args)
 	return exit_val;
 }
 
+/* joinable threads are released by openr2_thread_join() */
+static void * OR2_THREAD_CALLING_CONVENTION thread_launch_joinable(void *args)
+{
+	openr2_thread_t *thread = (openr2_thread_t *)args;
+	return thread->function(thread, thread->private_data);
+}
+
 openr2_status_t openr2_thread_create_detached(openr2_thread_function_t func, void *data)
 {
 	return openr2_thread_create_detached_ex(func, data, thread_default_stacksize);
@@ -161,6 +179,61 @@ openr2_status_t openr2_thread_create_detached_ex(openr2_thread_function_t func,
 	return status;
 }
 
+openr2_status_t openr2_thread_create_joinable(openr2_thread_t **thread, openr2_thread_function_t func, void *data)
+{
+	openr2_thread_t *newthread = NULL;
+
+	if (!func || !(newthread = (openr2_thread_t *)openr2_malloc(sizeof(openr2_thread_t)))) {
+		return OR2_FAIL;
+	}
+
+	newthread->private_data = data;
+	newthread->function = func;
+	newthread->stack_size = thread_default_stacksize;
+
+#if defined(WIN32)
+	newthread->handle = (void *)_beginthreadex(NULL, (unsigned)newthread->stack_size, (unsigned int (__stdcall *)(void *))thread_launch_joinable, newthread, 0, NULL);
+	if (!newthread->handle) {
+		goto fail;
+	}
+#else
+	if (pthread_attr_init(&newthread->attribute) != 0) goto fail;
+
+	if (newthread->stack_size && pthread_attr_setstacksize(&newthread->attribute, newthread->stack_size) != 0) goto failpthread;
+
+	if (pthread_create(&newthread->handle, &newthread->attribute, thread_launch_joinable, newthread) != 0) goto failpthread;
+#endif
+
+	*thread = newthread;
+	return OR2_SUCCESS;
+
+#ifndef WIN32
+ failpthread:
+	pthread_attr_destroy(&newthread->attribute);
+#endif
+ fail:
+	openr2_safe_free(newthread);
+	return OR2_FAIL;
+}
+
+openr2_status_t openr2_thread_join(openr2_thread_t *thread)
+{
+	openr2_status_t status = OR2_SUCCESS;
+#ifdef WIN32
+	if (WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) {
+		status = OR2_FAIL;
+	}
+	CloseHandle(thread->handle);
+#else
+	if (pthread_join(thread->handle, NULL)) {
+		status = OR2_FAIL;
+	}
+	pthread_attr_destroy(&thread->attribute);
+#endif
+	openr2_safe_free(thread);
+	return status;
+}
+
 
 openr2_status_t openr2_mutex_create(openr2_mutex_t **mutex)
 {
@@ -258,7 +331,9 @@ openr2_status_t _openr2_mutex_unlock(openr2_mutex_t *mutex)
 openr2_status_t openr2_interrupt_create(openr2_interrupt_t **ininterrupt, openr2_socket_t device)
 {
 	openr2_interrupt_t *interrupt = NULL;
-#ifndef WIN32
+#if defined(HAVE_SYS_EVENTFD_H)
+	int fd;
+#elif !defined(WIN32)
 	int fds[2];
 #endif
 
@@ -277,6 +352,15 @@ openr2_status_t openr2_interrupt_create(openr2_interrupt_t **ininterrupt, openr2
 		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to allocate interrupt event\n");
 		goto failed;
 	}
+#elif defined(HAVE_SYS_EVENTFD_H)
+	/* a single eventfd is cheaper to signal and drain than a pipe */
+	fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd == -1) {
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to allocate interrupt eventfd: %s\n", strerror(errno));
+		goto failed;
+	}
+	interrupt->readfd = fd;
+	interrupt->writefd = fd;
 #else
 	if (pipe(fds)) {
 		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to allocate interrupt pipe: %s\n", strerror(errno));
@@ -389,6 +473,13 @@ openr2_status_t openr2_interrupt_signal(openr2_interrupt_t *interrupt)
 		return OR2_FAIL;
 
 	}
+#elif defined(HAVE_SYS_EVENTFD_H)
+	uint64_t one = 1;
+	/* the eventfd counter just accumulates until the waiter drains it */
+	if (write(interrupt->writefd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to signal interrupt: %s\n", strerror(errno));
+		return OR2_FAIL;
+	}
 #else
 	int err;
 	struct pollfd testpoll;
@@ -418,7 +509,9 @@ openr2_status_t openr2_interrupt_destroy(openr2_interrupt_t **ininterrupt)
 	CloseHandle(interrupt->event);
 #else
 	close(interrupt->readfd);
-	close(interrupt->writefd);
+	if (interrupt->writefd != interrupt->readfd) {
+		close(interrupt->writefd);
+	}
 
 	interrupt->readfd = -1;
 	interrupt->writefd = -1;
@@ -514,6 +607,162 @@ pollagain:
 	return OR2_SUCCESS;
 }
 
+/* max number of ready interrupts handled on each wait of a set */
+#define OR2_INTERRUPT_SET_MAX_EVENTS 32
+
+struct openr2_interrupt_set {
+#ifdef HAVE_SYS_EPOLL_H
+	/* epoll set watching the interrupts and their devices */
+	int epfd;
+#endif
+	/* interrupts in the set */
+	openr2_interrupt_t **interrupts;
+	size_t len;
+	size_t size;
+};
+
+openr2_status_t openr2_interrupt_set_create(openr2_interrupt_set_t **inset)
+{
+	openr2_interrupt_set_t *set = NULL;
+
+	_openr2_assert_return(inset != NULL, OR2_FAIL, "interrupt set double pointer is null!\n");
+
+	set = openr2_calloc(1, sizeof(*set));
+	if (!set) {
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to allocate interrupt set memory\n");
+		return OR2_FAIL;
+	}
+#ifdef HAVE_SYS_EPOLL_H
+	set->epfd = epoll_create(OR2_INTERRUPT_SET_MAX_EVENTS);
+	if (set->epfd == -1) {
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to create interrupt set: %s\n", strerror(errno));
+		openr2_safe_free(set);
+		return OR2_FAIL;
+	}
+#endif
+	*inset = set;
+	return OR2_SUCCESS;
+}
+
+openr2_status_t openr2_interrupt_set_destroy(openr2_interrupt_set_t **inset)
+{
+	openr2_interrupt_set_t *set = NULL;
+	_openr2_assert_return(inset != NULL, OR2_FAIL, "Interrupt set null when destroying!\n");
+	set = *inset;
+#ifdef HAVE_SYS_EPOLL_H
+	close(set->epfd);
+#endif
+	openr2_safe_free(set->interrupts);
+	openr2_safe_free(set);
+	*inset = NULL;
+	return OR2_SUCCESS;
+}
+
+openr2_status_t openr2_interrupt_set_add(openr2_interrupt_set_t *set, openr2_interrupt_t *interrupt)
+{
+	openr2_interrupt_t **interrupts;
+	size_t size;
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event ev;
+#endif
+
+	_openr2_assert_return(set != NULL, OR2_FAIL, "Interrupt set is null!\n");
+	_openr2_assert_return(interrupt != NULL, OR2_FAIL, "Interrupt is null!\n");
+
+	if (set->len == set->size) {
+		size = set->size ? set->size * 2 : 16;
+		interrupts = openr2_realloc(set->interrupts, size * sizeof(*interrupts));
+		if (!interrupts) {
+			return OR2_FAIL;
+		}
+		set->interrupts = interrupts;
+		set->size = size;
+	}
+#ifdef HAVE_SYS_EPOLL_H
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = interrupt;
+	if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, interrupt->readfd, &ev)) {
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to add interrupt to set: %s\n", strerror(errno));
+		return OR2_FAIL;
+	}
+	if (interrupt->device != OR2_INVALID_SOCKET) {
+		/* NULL data means device activity, nothing to drain */
+		ev.data.ptr = NULL;
+		if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, interrupt->device, &ev)) {
+			openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "Failed to add interrupt device to set: %s\n", strerror(errno));
+			epoll_ctl(set->epfd, EPOLL_CTL_DEL, interrupt->readfd, &ev);
+			return OR2_FAIL;
+		}
+	}
+#endif
+	set->interrupts[set->len++] = interrupt;
+	return OR2_SUCCESS;
+}
+
+openr2_status_t openr2_interrupt_set_remove(openr2_interrupt_set_t *set, openr2_interrupt_t *interrupt)
+{
+	size_t i;
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event ev;
+#endif
+
+	_openr2_assert_return(set != NULL, OR2_FAIL, "Interrupt set is null!\n");
+
+	for (i = 0; i < set->len && set->interrupts[i] != interrupt; i++);
+	if (i == set->len) {
+		return OR2_FAIL;
+	}
+	set->interrupts[i] = set->interrupts[--set->len];
+#ifdef HAVE_SYS_EPOLL_H
+	/* older kernels require a non-NULL event even for EPOLL_CTL_DEL */
+	memset(&ev, 0, sizeof(ev));
+	epoll_ctl(set->epfd, EPOLL_CTL_DEL, interrupt->readfd, &ev);
+	if (interrupt->device != OR2_INVALID_SOCKET) {
+		epoll_ctl(set->epfd, EPOLL_CTL_DEL, interrupt->device, &ev);
+	}
+#endif
+	return OR2_SUCCESS;
+}
+
+openr2_status_t openr2_interrupt_set_wait(openr2_interrupt_set_t *set, int ms)
+{
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event events[OR2_INTERRUPT_SET_MAX_EVENTS];
+	openr2_interrupt_t *interrupt;
+	char pipebuf[255];
+	int res, i;
+
+	_openr2_assert_return(set != NULL, OR2_FAIL, "Interrupt set is null!\n");
+
+waitagain:
+	res = epoll_wait(set->epfd, events, OR2_INTERRUPT_SET_MAX_EVENTS, ms);
+	if (res == -1) {
+		if (errno == EINTR) {
+			goto waitagain;
+		}
+		openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "interrupt set wait failed (%s)\n", strerror(errno));
+		return OR2_FAIL;
+	}
+
+	if (res == 0) {
+		return OR2_TIMEOUT;
+	}
+
+	/* drain the signaled interrupts, NOT the devices */
+	for (i = 0; i < res; i++) {
+		interrupt = events[i].data.ptr;
+		if (interrupt && read(interrupt->readfd, pipebuf, sizeof(pipebuf)) == -1 && errno != EAGAIN) {
+			openr2_log_generic(OR2_GENERIC_LOG, OR2_LOG_ERROR, "reading interrupt descriptor failed (%s)\n", strerror(errno));
+		}
+	}
+	return OR2_SUCCESS;
+#else
+	_openr2_assert_return(set != NULL, OR2_FAIL, "Interrupt set is null!\n");
+	return openr2_interrupt_multiple_wait(set->interrupts, set->len, ms);
+#endif
+}
+
 unsigned long openr2_thread_self(void)
 {
 #ifdef WIN32
@@ -524,6 +773,26 @@ unsigned long openr2_thread_self(void)
 	
 }
 
+openr2_status_t openr2_thread_set_cpu_affinity(int cpu)
+{
+#if defined(WIN32)
+	if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)) {
+		return OR2_FAIL;
+	}
+	return OR2_SUCCESS;
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+		return OR2_FAIL;
+	}
+	return OR2_SUCCESS;
+#else
+	return OR2_FAIL;
+#endif
+}
+
 /* For Emacs:
  * Local Variables:
  * mode:c